@@ -25,6 +25,7 @@
 
 #include "../squares-and-circles-api.h"
 #include "misc/nes_noise.hxx"
+#include "misc/pitch.hxx"
 #include "stmlib/dsp/filter.h"
 
 class SquareOscillator
@@ -77,6 +78,7 @@ float cv;
 SquareOscillator _osc[6] = {};
 stmlib::DCBlocker _dc_blocker;
 float f = 1.f;
+float last_update[3] = {}; // cv, f0, f1 of the last update_oscillators()
 float f0 = 540;
 float f1 = 800;
 float gain = 1.f;
@@ -112,8 +114,14 @@ void setup()
 DSP_PROCESS
 void process()
 {
-    f = powf(2.f, cv);
-    update_oscillators();
+    if (cv != last_update[0] || f0 != last_update[1] || f1 != last_update[2])
+    {
+        last_update[0] = cv;
+        last_update[1] = f0;
+        last_update[2] = f1;
+        f = pitch::exp2(cv);
+        update_oscillators();
+    }
 
     for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
     {
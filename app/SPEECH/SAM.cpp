@@ -29,6 +29,7 @@
 #include <stdio.h>
 #include <algorithm>
 #include <inttypes.h>
+#include "misc/lru_cache.hxx"
 
 extern "C"
 {
@@ -80,35 +81,81 @@ static float _throat = 0.5f;
 
 static char _word_text[16] = {};
 
+// Rendered utterances are kept by word and voice (quantized to 32 steps, the cache would miss on
+// every knob jitter otherwise) - retriggering a word is plain playback, no SAM rendering at all.
+struct Utterance
+{
+  uint8_t word;
+  uint8_t speed;
+  uint8_t mouth;
+  uint8_t pitch;
+  uint8_t throat;
+
+  bool operator==(const Utterance &other) const
+  {
+    return memcmp(this, &other, sizeof(Utterance)) == 0;
+  }
+};
+
 static uint8_t _buffer[48000];
+static LRUPool<Utterance, 16> _cache;
+static const uint8_t *_buffer_data = nullptr; // valid until the next say()
 static size_t _buffer_len = 0;
 static uint32_t _buffer_pos = 0;
+static bool _rendering = false; // SAMRender a few samples ahead of the playback, into _cache.pending()
+
+static uint8_t quantize(float value)
+{
+  return (uint8_t)(std::min(std::max(value, 0.f), 1.f) * 31 + 0.5f) * 255 / 31;
+}
 
 void say()
 {
+  Utterance key = {_word, quantize(1.f - _speed), quantize(_mouth), quantize(_pitch), quantize(_throat)};
+
+  const char *phonems = _phenoms[_word];
+  char rnd[8];
   if (_word == LEN_OF(_phenoms) - 1)
   {
-    sprintf(_phenoms[_word], "%d[]", rand() % 10);
-    TextToPhonemes((unsigned char *)_phenoms[_word]);
+    int digit = rand() % 10;
+    key.word += digit;
+    sprintf(rnd, "%d[]", digit);
+    phonems = rnd;
   }
 
+  _rendering = false;
+  _buffer_pos = 0;
+
+  if ((_buffer_data = _cache.find(key, &_buffer_len)) != nullptr)
+    return;
+
+  if (phonems == rnd)
+    TextToPhonemes((unsigned char *)rnd);
+
   SAM_write_buffer = [](int pos, char value)
   {
-    if (pos < (int)LEN_OF(_buffer))
+    // evicts older utterances as the new one grows
+    if (_cache.grow(pos + 1))
     {
-      _buffer_len = pos + 1;
-      _buffer[pos] = value;
+      _buffer_len = std::max(_buffer_len, (size_t)pos + 1);
+      _cache.pending()[pos] = value;
     }
   };
 
-  SetSpeed((1.f - _speed) * 255);
-  SetMouth(_mouth * 255);
-  SetPitch(_pitch * 255);
-  SetThroat(_throat * 255);
+  SetSpeed(key.speed);
+  SetMouth(key.mouth);
+  SetPitch(key.pitch);
+  SetThroat(key.throat);
 
-  SetInput(_phenoms[_word]);
-  SAMMain();
-  _buffer_pos = 0;
+  _buffer_len = 0;
+  _cache.reserve(key);
+  SetInput((char *)phonems);
+  _rendering = SAMPrepare();
+  if (!_rendering)
+  {
+    _buffer_data = _cache.pending();
+    _cache.commit(_buffer_len);
+  }
 }
 
 GFX_DISPLAY
@@ -134,6 +181,7 @@ void setup()
 
   dsp_frame_f(OUTPUT_L, frame);
   init_phenoms();
+  _cache.init(_buffer, sizeof(_buffer));
 }
 
 DSP_PROCESS
@@ -146,11 +194,20 @@ void process()
     say();
   }
 
+  // 12 samples per block, the speech starts in the block of the trigger
+  if (_rendering)
+  {
+    _rendering = SAMRender(12) && _buffer_len < _cache.size;
+    _buffer_data = _cache.pending();
+    if (!_rendering)
+      _cache.commit(_buffer_len);
+  }
+
   if (_buffer_pos + 12 < _buffer_len)
   {
     for (int j = 0; j < 24; j += 2)
     {
-      float sample = ((float)_buffer[_buffer_pos] - 127) / 128;
+      float sample = ((float)_buffer_data[_buffer_pos] - 127) / 128;
       frame[j] = frame[j + 1] = sample;
       ++_buffer_pos;
     }
@@ -52,7 +52,9 @@
 #define GFX_DISPLAY WASM_EXPORT_AS("_display")
 #define GFX_SCREENSAVER WASM_EXPORT_AS("_screensaver")
 
+#ifndef FRAME_BUFFER_SIZE
 #define FRAME_BUFFER_SIZE 24
+#endif
 
 extern "C"
 {
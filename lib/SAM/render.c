@@ -354,19 +354,29 @@ pos48315:
 
 
 
+// State of the output loop between RenderChunk() calls
+static struct
+{
+    unsigned char phase1, phase2, phase3;
+    unsigned char mem66, mem38, mem44, mem48;
+    unsigned char speedcounter;
+    unsigned char Y;
+} render_state;
+
 //void Code47574()
-void Render()
+// Creates the frames of the phrase in phonemeIndexOutput, 0 if there is nothing to render.
+// The sound output follows with RenderChunk().
+int RenderBegin()
 {
     unsigned char phase1 = 0;  //mem43
     unsigned char phase2=0;
     unsigned char phase3=0;
-    unsigned char mem66=0;
     unsigned char mem38=0;
     unsigned char mem40=0;
     unsigned char speedcounter=0; //mem45
     unsigned char mem48=0;
     int i;
-    if (phonemeIndexOutput[0] == 255) return; //exit if no data
+    if (phonemeIndexOutput[0] == 255) return 0; //exit if no data
 
     A = 0;
     X = 0;
@@ -781,6 +791,32 @@ do
     PrintOutput(sampledConsonantFlag, frequency1, frequency2, frequency3, amplitude1, amplitude2, amplitude3, pitches);
 #endif
 
+    render_state.phase1 = phase1;
+    render_state.phase2 = phase2;
+    render_state.phase3 = phase3;
+    render_state.mem66 = 0;
+    render_state.mem38 = mem38;
+    render_state.mem44 = mem44;
+    render_state.mem48 = mem48;
+    render_state.speedcounter = speedcounter;
+    render_state.Y = Y;
+    return 1;
+}
+
+// Renders the frames until the output position (bufferpos/50) reaches until - all samples
+// before it are final then. Returns 0 when the phrase is complete, 1 if it has to be resumed.
+int RenderChunk(int until)
+{
+    unsigned char phase1 = render_state.phase1;
+    unsigned char phase2 = render_state.phase2;
+    unsigned char phase3 = render_state.phase3;
+    unsigned char mem66 = render_state.mem66;
+    unsigned char mem38 = render_state.mem38;
+    unsigned char mem48 = render_state.mem48;
+    unsigned char speedcounter = render_state.speedcounter;
+    Y = render_state.Y;
+    mem44 = render_state.mem44;
+
 // PROCESS THE FRAMES
 //
 // In traditional vocal synthesis, the glottal pulse drives filters, which
@@ -794,6 +830,21 @@ do
     //pos48078:
     while(1)
     {
+        // stop between two frames, continue with the next call
+        if (bufferpos / 50 >= until)
+        {
+            render_state.phase1 = phase1;
+            render_state.phase2 = phase2;
+            render_state.phase3 = phase3;
+            render_state.mem66 = mem66;
+            render_state.mem38 = mem38;
+            render_state.mem44 = mem44;
+            render_state.mem48 = mem48;
+            render_state.speedcounter = speedcounter;
+            render_state.Y = Y;
+            return 1;
+        }
+
         // get the sampled information on the phoneme
         A = sampledConsonantFlag[Y];
         mem39 = A;
@@ -842,7 +893,7 @@ do
         }
 
         // if the frame count is zero, exit the loop
-        if(mem48 == 0)  return;
+        if(mem48 == 0)  return 0;
         speedcounter = speed;
 pos48155:
 
@@ -937,7 +988,13 @@ pos48159:
     mem44 = 1;
     mem66 = Y;
     Y = mem49;
-    return;
+    return 0;
+}
+
+void Render()
+{
+    if (RenderBegin())
+        while (RenderChunk(0x7fffffff));
 }
 
 
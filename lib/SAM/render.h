@@ -2,6 +2,8 @@
 #define RENDER_H
 
 void Render();
+int RenderBegin();
+int RenderChunk(int until);
 void SetMouthThroat(unsigned char mouth, unsigned char throat);
 
 #endif
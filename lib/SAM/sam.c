@@ -44,6 +44,11 @@ unsigned char phonemeLengthOutput[60]; //tab47416
 int bufferpos=0;
 char *buffer = NULL;
 
+// PrepareOutput()/SAMRender() progress through the phoneme list
+static unsigned char prepareX = 0;
+static int prepareDone = 1;
+static int rendering = 0;
+
 
 void SetInput(char *_input)
 {
@@ -74,6 +79,7 @@ void Code41240();
 void Insert(unsigned char position, unsigned char mem60, unsigned char mem59, unsigned char mem58);
 void InsertBreath();
 void PrepareOutput();
+int PrepareNextPhrase();
 void SetMouthThroat(unsigned char mouth, unsigned char throat);
 
 // 168=pitches
@@ -146,7 +152,8 @@ void Init()
 
 
 //int Code39771()
-int SAMMain()
+// Parses the input into the phoneme list, the sound is rendered by PrepareOutput() or SAMRender()
+int SAMPrepare()
 {
     Init();
     phonemeindex[255] = 32; //to prevent buffer overflow
@@ -179,20 +186,47 @@ int SAMMain()
         PrintPhonemes(phonemeindex, phonemeLength, stress);
 #endif
 
+    prepareX = 0;
+    prepareDone = 0;
+    rendering = 0;
+    return 1;
+}
+
+int SAMMain()
+{
+    if (!SAMPrepare()) return 0;
+
     PrepareOutput();
 
     return 1;
 }
 
+int SAMRender(int samples)
+{
+    int until = bufferpos / 50 + samples;
 
-//void Code48547()
-void PrepareOutput()
+    while (bufferpos / 50 < until)
+    {
+        if (rendering)
+            rendering = RenderChunk(until);
+        else if (PrepareNextPhrase())
+            rendering = RenderBegin();
+        else
+            return 0;
+    }
+
+    return 1;
+}
+
+// Copies the next phrase (up to a breath or the end) into the output tables, 0 if there is none left
+int PrepareNextPhrase()
 {
+    if (prepareDone) return 0;
+
     A = 0;
-    X = 0;
+    X = prepareX;
     Y = 0;
 
-    //pos48551:
     while(1)
     {
         A = phonemeindex[X];
@@ -200,20 +234,15 @@ void PrepareOutput()
         {
             A = 255;
             phonemeIndexOutput[Y] = 255;
-            Render();
-            return;
+            prepareDone = 1;
+            return 1;
         }
         if (A == 254)
         {
             X++;
-            int temp = X;
-            //mem[48546] = X;
             phonemeIndexOutput[Y] = 255;
-            Render();
-            //X = mem[48546];
-            X=temp;
-            Y = 0;
-            continue;
+            prepareX = X;
+            return 1;
         }
 
         if (A == 0)
@@ -230,6 +259,13 @@ void PrepareOutput()
     }
 }
 
+//void Code48547()
+void PrepareOutput()
+{
+    while (PrepareNextPhrase())
+        Render();
+}
+
 //void Code48431()
 void InsertBreath()
 {
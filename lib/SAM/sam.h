@@ -10,6 +10,11 @@ void EnableSingmode();
 void EnableDebug();
 
 int SAMMain();
+
+// SAMMain in steps: SAMPrepare() parses the input, every SAMRender(n) call renders (at least)
+// the next n samples through SAM_write_buffer, 0 when the utterance is complete.
+int SAMPrepare();
+int SAMRender(int samples);
 extern void (*SAM_write_buffer)(int pos, char value); //Overwrite for own buffer
 
 char* GetBuffer();
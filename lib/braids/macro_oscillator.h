@@ -39,6 +39,9 @@
 #include "braids/settings.h"
 
 namespace braids {
+
+// Max. size of one Render call
+const size_t kMaxBlockSize = 24;
   
 class MacroOscillator {
  public:
@@ -99,8 +102,8 @@ class MacroOscillator {
   int16_t parameter_[2];
   int16_t previous_parameter_[2];
   int16_t pitch_;
-  uint8_t sync_buffer_[24];
-  int16_t temp_buffer_[24];
+  uint8_t sync_buffer_[kMaxBlockSize];
+  int16_t temp_buffer_[kMaxBlockSize];
   int32_t lp_state_;
   
   AnalogOscillator analog_oscillator_[3];
@@ -388,12 +388,17 @@ struct drum_synth_Part
     }
 };
 
+extern "C" size_t drum_synth_size(size_t parts)
+{
+    return 4 + (sizeof(drum_synth_Part) * parts);
+}
+
 extern "C" DrumSynth drum_synth_init(const DrumModel *inst, void *(*malloc)(size_t size))
 {
     if (malloc == nullptr)
         malloc = ::malloc;
 
-    const size_t malloc_size = (4 + (sizeof(drum_synth_Part) * inst->n));
+    const size_t malloc_size = drum_synth_size(inst->n);
 
     if (auto p = (DrumSynth)malloc(malloc_size))
     {
@@ -135,6 +135,7 @@ typedef uint32_t *DrumSynth;
 extern "C"
 {
     DrumSynth drum_synth_init(const DrumModel *inst, void *(*malloc)(size_t size));
+    size_t drum_synth_size(size_t parts); // bytes drum_synth_init() allocates for an instrument with n parts
     void drum_synth_process_frame(DrumSynth inst, int part, float freq, const DrumParams *params, float *out, size_t size);
     void drum_synth_reset(DrumSynth inst);
 }
\ No newline at end of file
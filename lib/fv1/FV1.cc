@@ -0,0 +1,823 @@
+// Copyright (C)2021 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// Portable implementation of the FV1.S API for non-ARM targets (test/host).
+//
+// Same fixed point arithmetic (S.23 in 32 bit, saturated to 24 bit), same pre-decoding of the
+// 128 instruction words (incl. the special cases and the WRAX 0 + RDAX fusion) and the same
+// LFO/ramp update as the Cortex-M7 version, so a FV1_ROM program renders the same output.
+// The compiled programs of fv1_programs[] run as instruction tables generated from the spn
+// sources (spn_compile.py, with the coefficients of FV1.S). test/host/fv1_ref.py compares
+// both with FV1.S.
+
+#ifndef __arm__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "fv1/FV1.h"
+#include "msfa/exp2.h"
+
+extern "C"
+{
+    // Dispatch of the decoded program: true = threaded code (computed goto), false = switch
+    bool fv1_threaded = true;
+}
+
+namespace
+{
+    enum Reg
+    {
+        SIN0_RATE = 0x00,
+        SIN0_RANGE,
+        SIN1_RATE,
+        SIN1_RANGE,
+        RMP0_RATE,
+        RMP0_RANGE,
+        RMP1_RATE,
+        RMP1_RANGE,
+        POT0 = 0x10,
+        POT1,
+        POT2,
+        ADCL = 0x14,
+        ADCR,
+        DACL,
+        DACR,
+        ADDR_PTR,
+        REG0 = 0x20,
+    };
+
+    // Handlers in the order of the FV1.S dispatch table, the ones after END are special cases
+    enum Op : uint8_t
+    {
+        RDA,
+        RMPA,
+        WRA,
+        WRAP,
+        RDAX,
+        RDFX,
+        WRAX,
+        WRHX,
+        WRLX,
+        MAXX,
+        MULX,
+        LOG,
+        EXP,
+        SOF,
+        AND,
+        OR,
+        XOR,
+        SKP,
+        WLDS,
+        JAM,
+        CHO_RDA,
+        WLDR,
+        CHO_SOF,
+        CHO_RDAL,
+        END,
+        NOP,
+        SOF_C0,      // SOF 0, D
+        SOF_C1,      // SOF 1, D
+        SOF_D0,      // SOF C, 0
+        EXP_C1_D0,   // EXP 1, 0
+        RDAX_C1,     // RDAX reg, 1
+        WRAX_C1,     // WRAX reg, 1
+        WRAX0_RDAX,  // WRAX reg, 0 + RDAX reg2, C
+        RDFX_C0,     // RDFX reg, 0
+        NUM_OPS,
+    };
+
+    enum ChoFlags
+    {
+        COS = 0x01,
+        COMPC = 0x04,
+        COMPA = 0x08,
+        RPTR2 = 0x10,
+        NA = 0x20,
+    };
+
+    struct Instr
+    {
+        uint8_t op;
+        int32_t a; // register or address
+        int32_t b;
+        int32_t c;
+    };
+
+    constexpr int32_t ONE = 1 << 23;
+    constexpr int32_t RAMP_MAX = 0x3FFFFF;
+    constexpr int RAM_SIZE = 32768;
+    constexpr int PROG_SIZE = 128;
+
+    inline int32_t ssat24(int32_t x)
+    {
+        return x < -ONE ? -ONE : (x > ONE - 1 ? ONE - 1 : x);
+    }
+
+    inline int32_t mul(int32_t a, int32_t b)
+    {
+        return (int32_t)(((int64_t)a * b) >> 23);
+    }
+
+    // vcvt.s32.f32 #23 (truncation, saturation)
+    inline int32_t to_s23(float x)
+    {
+        x *= (float)ONE;
+        if (!(x == x))
+            return 0;
+        if (x >= 2147483648.f)
+            return INT32_MAX;
+        if (x <= -2147483648.f)
+            return INT32_MIN;
+        return (int32_t)x;
+    }
+
+    // LOG: log2(|acc|) / 16 (quadratic mantissa approximation)
+    inline int32_t log2_s19(int32_t x)
+    {
+        if (x == 0)
+            return -(ONE - 1);
+
+        float f = (float)(x < 0 ? -x : x) * (1.f / ONE);
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        int32_t e = (int32_t)((bits >> 23) & 0xFF) - 128;
+        bits = (bits & ~0x7F800000u) + 0x3F800000u;
+        float m;
+        memcpy(&m, &bits, sizeof(m));
+
+        float p = fmaf(m, -0.33333334f, 2.f);
+        float y = fmaf(m, p, (float)e - 0.6666667f);
+        return (int32_t)(y * (float)(1 << 19));
+    }
+
+    // EXP of a negative acc via the msfa exp2 table
+    inline int32_t exp2_s23(int32_t x)
+    {
+        int32_t y = Exp2::lookup((int32_t)((uint32_t)x << 5));
+        if (y < 0)
+            y += 1;
+        return ssat24(y >> 1);
+    }
+
+    uint64_t prng_state = 1234;
+
+    uint32_t prng()
+    {
+        prng_state ^= prng_state >> 12;
+        prng_state ^= prng_state << 25;
+        prng_state ^= prng_state >> 27;
+        return (prng_state * 0x2545F4914F6CDD1DULL) >> 32;
+    }
+} // namespace
+
+struct FV1
+{
+    int32_t acc;
+    int32_t pacc;
+    int32_t lr;
+    int32_t regs[64];
+    int32_t ram[RAM_SIZE];
+    int32_t ptr; // delay line write position, decremented every sample
+
+    struct
+    {
+        int32_t s;
+        int32_t c;
+    } sin[2];
+
+    int32_t rmp[2];
+    uint8_t first; // SKP RUN
+    FV1FX program;
+    Instr *instr;
+};
+
+namespace
+{
+    inline int32_t &ram(FV1 *fv1, int32_t addr)
+    {
+        return fv1->ram[(fv1->ptr + addr) & (RAM_SIZE - 1)];
+    }
+
+    inline int32_t sin_value(FV1 *fv1, int n, int flags)
+    {
+        int32_t v = (flags & COS) ? fv1->sin[n].c : fv1->sin[n].s;
+        return mul(v, fv1->regs[n ? SIN1_RANGE : SIN0_RANGE]);
+    }
+
+    // Coefficient (and address offset) of a ramp for CHO RDA/SOF
+    inline int32_t ramp_value(FV1 *fv1, int k, int flags, int32_t &offset)
+    {
+        const int32_t shift = fv1->regs[k ? RMP1_RANGE : RMP0_RANGE] >> 21;
+        const int32_t max = RAMP_MAX >> shift;
+        const int32_t pos = fv1->rmp[k];
+
+        int32_t v = (flags & RPTR2) ? ((pos + (max >> 1)) & max) : pos;
+        if (flags & COMPA)
+            v = max - v;
+
+        if (flags & NA)
+            v = (pos > (max >> 1) ? max - pos : pos) << shift;
+
+        offset = v;
+        return v;
+    }
+
+    template <bool threaded>
+    void execute_program(FV1 *fv1, const Instr *i)
+    {
+#if defined(__GNUC__)
+        static const void *labels[NUM_OPS] = {
+            &&L_RDA, &&L_RMPA, &&L_WRA, &&L_WRAP, &&L_RDAX, &&L_RDFX, &&L_WRAX, &&L_WRHX, &&L_WRLX,
+            &&L_MAXX, &&L_MULX, &&L_LOG, &&L_EXP, &&L_SOF, &&L_AND, &&L_OR, &&L_XOR, &&L_SKP,
+            &&L_WLDS, &&L_JAM, &&L_CHO_RDA, &&L_WLDR, &&L_CHO_SOF, &&L_CHO_RDAL, &&L_END, &&L_NOP,
+            &&L_SOF_C0, &&L_SOF_C1, &&L_SOF_D0, &&L_EXP_C1_D0, &&L_RDAX_C1, &&L_WRAX_C1,
+            &&L_WRAX0_RDAX, &&L_RDFX_C0};
+#define CASE(name) \
+    case name:     \
+    L_##name:
+#define NEXT()                    \
+    if (threaded)                 \
+        goto *labels[(++i)->op];  \
+    continue
+#else
+#define CASE(name) case name:
+#define NEXT() continue
+#endif
+
+        int32_t *regs = fv1->regs;
+        int32_t &acc = fv1->acc;
+        int32_t &pacc = fv1->pacc;
+        int32_t &lr = fv1->lr;
+
+#if defined(__GNUC__)
+        if (threaded)
+            goto *labels[i->op];
+#endif
+
+        for (;; i++)
+        {
+            switch (i->op)
+            {
+                CASE(RDA)
+                {
+                    int32_t v = ram(fv1, i->a);
+                    pacc = acc;
+                    lr = ssat24(v);
+                    acc = ssat24(acc + mul(v, i->b));
+                    NEXT();
+                }
+                CASE(RMPA)
+                {
+                    int32_t v = ram(fv1, regs[ADDR_PTR] >> 8);
+                    pacc = acc;
+                    lr = ssat24(v);
+                    acc = ssat24(acc + ssat24(mul(v, i->a)));
+                    NEXT();
+                }
+                CASE(WRA)
+                {
+                    ram(fv1, i->a) = acc;
+                    pacc = acc;
+                    acc = ssat24(mul(acc, i->b));
+                    NEXT();
+                }
+                CASE(WRAP)
+                {
+                    ram(fv1, i->a) = acc;
+                    pacc = acc;
+                    acc = ssat24(ssat24(mul(acc, i->b)) + lr);
+                    NEXT();
+                }
+                CASE(RDAX)
+                {
+                    pacc = acc;
+                    acc = ssat24(acc + mul(regs[i->a], i->b));
+                    NEXT();
+                }
+                CASE(RDFX)
+                {
+                    pacc = acc;
+                    acc = ssat24(regs[i->a] + mul(acc - regs[i->a], i->b));
+                    NEXT();
+                }
+                CASE(WRAX)
+                {
+                    pacc = acc;
+                    regs[i->a] = acc;
+                    acc = ssat24(mul(acc, i->b));
+                    NEXT();
+                }
+                CASE(WRHX)
+                {
+                    int32_t p = pacc;
+                    pacc = acc;
+                    regs[i->a] = acc;
+                    acc = ssat24(p + mul(acc, i->b));
+                    NEXT();
+                }
+                CASE(WRLX)
+                {
+                    int32_t p = pacc;
+                    pacc = acc;
+                    regs[i->a] = acc;
+                    acc = ssat24(p + mul(p - acc, i->b));
+                    NEXT();
+                }
+                CASE(MAXX)
+                {
+                    pacc = acc;
+                    int32_t r = regs[i->a];
+                    r = ssat24(mul(r < 0 ? -r : r, i->b));
+                    r = r < 0 ? -r : r;
+                    int32_t a = acc < 0 ? -acc : acc;
+                    acc = ssat24(a < r ? r : a);
+                    NEXT();
+                }
+                CASE(MULX)
+                {
+                    pacc = acc;
+                    acc = ssat24(mul(acc, regs[i->a]));
+                    NEXT();
+                }
+                CASE(LOG)
+                {
+                    pacc = acc;
+                    acc = ssat24(mul(log2_s19(acc), i->a) + i->b);
+                    NEXT();
+                }
+                CASE(EXP)
+                {
+                    pacc = acc;
+                    int32_t e = acc < 0 ? exp2_s23(acc) : ONE - 1;
+                    acc = ssat24(i->b + mul(e, i->a));
+                    NEXT();
+                }
+                CASE(SOF)
+                {
+                    pacc = acc;
+                    acc = ssat24(i->b + mul(acc, i->a));
+                    NEXT();
+                }
+                CASE(AND)
+                {
+                    pacc = acc;
+                    int32_t r = acc & i->a;
+                    if (r & 0xFF800000)
+                        r |= 0xFF000000;
+                    acc = ssat24(r);
+                    NEXT();
+                }
+                CASE(OR)
+                {
+                    pacc = acc;
+                    int32_t r = acc | i->a;
+                    if (r & 0xFF800000)
+                        r |= 0xFF000000;
+                    acc = ssat24(r);
+                    NEXT();
+                }
+                CASE(XOR)
+                {
+                    pacc = acc;
+                    int32_t r = acc ^ i->a;
+                    if (r & 0xFF800000)
+                        r |= 0xFF000000;
+                    acc = ssat24(r);
+                    NEXT();
+                }
+                CASE(SKP)
+                {
+                    // the conditions are or'ed, N counts decoded instructions (like FV1.S)
+                    const int32_t flags = i->a;
+                    bool skip = (flags & 0x10) && !fv1->first;
+                    skip |= (flags & 0x04) && acc == 0;
+                    skip |= (flags & 0x02) && acc > 0;
+                    skip |= (flags & 0x01) && acc < 0;
+                    skip |= (flags & 0x08) && ((acc ^ pacc) & ONE);
+                    if (skip)
+                        i += i->b;
+                    NEXT();
+                }
+                CASE(WLDS)
+                {
+                    const int n = i->a;
+                    regs[n ? SIN1_RATE : SIN0_RATE] = ssat24(i->b << 14);
+                    regs[n ? SIN1_RANGE : SIN0_RANGE] = ssat24(i->c << 8);
+                    fv1->sin[n].s = 0;
+                    fv1->sin[n].c = -(ONE - 1);
+                    NEXT();
+                }
+                CASE(JAM)
+                {
+                    fv1->rmp[i->a] = 0;
+                    NEXT();
+                }
+                CASE(CHO_RDA)
+                {
+                    const int n = i->a;
+                    const int flags = i->b;
+                    int32_t addr = i->c;
+                    int32_t offset, k;
+
+                    if (n < 2)
+                    {
+                        offset = sin_value(fv1, n, flags);
+                        k = (flags & COMPC) ? RAMP_MAX - offset : offset;
+                        if (flags & COMPA)
+                            offset = -offset;
+                    }
+                    else
+                    {
+                        k = ramp_value(fv1, n - 2, flags, offset);
+                        if (flags & COMPC)
+                            k = RAMP_MAX - k;
+                    }
+
+                    if (!(flags & NA))
+                        addr += offset >> 10;
+
+                    int32_t v = ram(fv1, addr);
+                    pacc = acc;
+                    lr = ssat24(v);
+                    acc = ssat24(acc + mul(v, k));
+                    NEXT();
+                }
+                CASE(WLDR)
+                {
+                    const int n = i->a;
+                    regs[n ? RMP1_RATE : RMP0_RATE] = ssat24(i->b << 8);
+                    regs[n ? RMP1_RANGE : RMP0_RANGE] = ssat24(i->c << 21);
+                    fv1->rmp[n] = 0;
+                    NEXT();
+                }
+                CASE(CHO_SOF)
+                {
+                    const int n = i->a;
+                    const int flags = i->b;
+                    int32_t k, offset;
+
+                    if (n < 2)
+                        k = sin_value(fv1, n, flags);
+                    else
+                        k = ramp_value(fv1, n - 2, flags, offset);
+
+                    if (flags & COMPC)
+                        k = RAMP_MAX - k;
+
+                    pacc = acc;
+                    acc = ssat24(i->c + mul(acc, k));
+                    NEXT();
+                }
+                CASE(CHO_RDAL)
+                {
+                    pacc = acc;
+                    switch (i->a)
+                    {
+                    case 0:
+                    case 1:
+                        acc = ssat24(sin_value(fv1, i->a, 0));
+                        break;
+                    default:
+                        acc = ssat24(fv1->rmp[i->a - 2]);
+                        break;
+                    }
+                    NEXT();
+                }
+                CASE(END)
+                {
+                    return;
+                }
+                CASE(NOP)
+                {
+                    NEXT();
+                }
+                CASE(SOF_C0)
+                {
+                    acc = ssat24(i->b);
+                    NEXT();
+                }
+                CASE(SOF_C1)
+                {
+                    acc = ssat24(i->b + acc);
+                    NEXT();
+                }
+                CASE(SOF_D0)
+                {
+                    acc = ssat24(mul(acc, i->a));
+                    NEXT();
+                }
+                CASE(EXP_C1_D0)
+                {
+                    pacc = acc;
+                    acc = acc < 0 ? exp2_s23(acc) : ONE - 1;
+                    NEXT();
+                }
+                CASE(RDAX_C1)
+                {
+                    pacc = acc;
+                    acc = ssat24(acc + regs[i->a]);
+                    NEXT();
+                }
+                CASE(WRAX_C1)
+                {
+                    pacc = acc;
+                    regs[i->a] = acc;
+                    NEXT();
+                }
+                CASE(WRAX0_RDAX)
+                {
+                    regs[i->a] = ssat24(acc);
+                    acc = ssat24(mul(regs[i->b], i->c));
+                    NEXT();
+                }
+                CASE(RDFX_C0)
+                {
+                    pacc = acc;
+                    acc = regs[i->a];
+                    NEXT();
+                }
+            default:
+                return;
+            }
+        }
+#undef CASE
+#undef NEXT
+    }
+
+    template <bool threaded>
+    void loaded_program(FV1 *fv1)
+    {
+        execute_program<threaded>(fv1, fv1->instr);
+    }
+
+#include "spn/spn_programs.h"
+
+    template <const Instr *program>
+    void compiled_program(FV1 *fv1)
+    {
+        execute_program<true>(fv1, program);
+    }
+
+    // Instruction word -> Instr (FV1.S fv1_load)
+    Instr decode(uint32_t w, const Instr *prev, bool &fused)
+    {
+        const int32_t c11 = ((int32_t)(w & 0xFFE00000) / 256) * 2; // S1.9
+        const int32_t c16 = ((int32_t)(w & 0xFFFF0000) / 256) * 2; // S1.14
+        const int32_t d11 = ((int32_t)((w << 16) & 0xFFE00000) / 256); // S.10
+        const int op = w & 31;
+
+        fused = false;
+
+        switch (op)
+        {
+        case RDA:
+        case WRA:
+        case WRAP:
+            return {(uint8_t)op, (int32_t)((w >> 5) & 0xFFFF), c11, 0};
+        case RMPA:
+            return {RMPA, c11, 0, 0};
+        case RDAX:
+        case RDFX:
+        case WRAX:
+        case WRHX:
+        case WRLX:
+        case MAXX:
+        case MULX:
+        {
+            const int32_t reg = (w >> 5) & 0x3F;
+            if (op == RDAX)
+            {
+                if (c16 == ONE)
+                    return {RDAX_C1, reg, 0, 0};
+
+                if (prev && prev->op == WRAX && prev->b == 0)
+                {
+                    fused = true;
+                    return {WRAX0_RDAX, prev->a, reg, c16};
+                }
+            }
+            else if (op == WRAX && c16 == ONE)
+                return {WRAX_C1, reg, c16, 0};
+            else if (op == RDFX && c16 == 0)
+                return {RDFX_C0, reg, c16, 0};
+
+            return {(uint8_t)op, reg, c16, 0};
+        }
+        case LOG:
+        case EXP:
+        case SOF:
+            if (op == SOF)
+            {
+                if (c16 == 0)
+                    return {SOF_C0, c16, d11, 0};
+                if (c16 == ONE)
+                    return {SOF_C1, c16, d11, 0};
+                if (d11 == 0)
+                    return {SOF_D0, c16, d11, 0};
+            }
+            else if (op == EXP && c16 == ONE && d11 == 0)
+                return {EXP_C1_D0, c16, d11, 0};
+
+            return {(uint8_t)op, c16, d11, 0};
+        case AND:
+        case OR:
+        case XOR:
+            return {(uint8_t)op, (int32_t)(w >> 8), 0, 0};
+        case SKP:
+            return {SKP, (int32_t)(w >> 27), (int32_t)((w >> 21) & 0x3F), 0};
+        case WLDS: // WLDS / WLDR
+            if (w & 0x40000000)
+                return {WLDR, (int32_t)((w >> 29) & 1), (int32_t)((w >> 13) & 0xFFFF), (int32_t)((w >> 5) & 3)};
+            else
+                return {WLDS, (int32_t)((w >> 29) & 1), (int32_t)((w >> 20) & 0x1FF), (int32_t)((w >> 5) & 0x7FFF)};
+        case JAM:
+            return {JAM, (int32_t)((w >> 6) & 1), 0, 0};
+        case CHO_RDA:
+        {
+            const int32_t n = (w >> 21) & 3;
+            const int32_t flags = (w >> 24) & 0x3F;
+            const int32_t arg = (w >> 5) & 0xFFFF;
+            switch (w & 0xC0000000)
+            {
+            case 0x80000000:
+                return {CHO_SOF, n, flags, arg};
+            case 0xC0000000:
+                return {CHO_RDAL, n, flags, arg};
+            default:
+                return {CHO_RDA, n, flags, arg};
+            }
+        }
+        default:
+            return {RDA, 0, 0, 0};
+        }
+    }
+} // namespace
+
+extern "C"
+{
+    FV1FX fv1_programs[256] = {
+        compiled_program<dance_ir_h_l_spn>,
+        compiled_program<OEM1_4_spn>,
+    };
+
+    FV1 *fv1_init(void *(*malloc)(size_t size))
+    {
+        FV1 *fv1 = (FV1 *)(malloc ? malloc : ::malloc)(sizeof(FV1));
+        if (fv1 == nullptr)
+            return nullptr;
+
+        memset(fv1, 0, sizeof(FV1));
+        fv1->first = 1;
+        fv1->sin[0].c = -(ONE - 1);
+        fv1->sin[1].c = -(ONE - 1);
+        return fv1;
+    }
+
+    void fv1_set_fx(FV1 *fv1, int program)
+    {
+        if (fv1 == nullptr)
+            return;
+
+        fv1->first = 1;
+        fv1->acc = fv1->pacc = 0;
+        memset(&fv1->regs[REG0], 0, 31 * sizeof(int32_t));
+        fv1->program = fv1_programs[program];
+    }
+
+    void *fv1_load(FV1 *fv1, const uint8_t *prog, void *(*malloc)(size_t size))
+    {
+        Instr *instr = (Instr *)(malloc ? malloc : ::malloc)(sizeof(Instr) * (PROG_SIZE + 1));
+        if (instr == nullptr)
+            return nullptr;
+
+        int n = 0;
+
+        if (prog == nullptr)
+        {
+            for (; n < PROG_SIZE; n++)
+                instr[n] = {NOP, 0, 0, 0};
+        }
+        else
+        {
+            for (int k = 0; k < PROG_SIZE; k++)
+            {
+                uint32_t w = (prog[k * 4] << 24) | (prog[k * 4 + 1] << 16) | (prog[k * 4 + 2] << 8) | prog[k * 4 + 3];
+                if (w == 0x11) // SKP 0,0 (NOP) ends the program
+                    break;
+
+                bool fused;
+                Instr d = decode(w, n > 0 ? &instr[n - 1] : nullptr, fused);
+                if (fused)
+                    instr[n - 1] = d;
+                else
+                    instr[n++] = d;
+            }
+        }
+
+        instr[n] = {END, 0, 0, 0};
+
+        fv1->instr = instr;
+        fv1->first = 1;
+        fv1->acc = fv1->pacc = 0;
+        memset(&fv1->regs[REG0], 0, 31 * sizeof(int32_t));
+        fv1->program = fv1_threaded ? loaded_program<true> : loaded_program<false>;
+        return instr;
+    }
+
+    void fv1_process(FV1 *fv1, const float *inL, const float *inR, float pot0, float pot1, float pot2, float *outL, float *outR, unsigned int size)
+    {
+        if (fv1 == nullptr)
+            return;
+
+        const int32_t p0 = to_s23(pot0);
+        const int32_t p1 = to_s23(pot1);
+        const int32_t p2 = to_s23(pot2);
+
+        for (unsigned int i = 0; i < size; i++)
+        {
+            int32_t *regs = fv1->regs;
+            regs[ADCL] = ssat24(to_s23(inL[i]));
+            regs[ADCR] = ssat24(to_s23(inR[i]));
+            regs[POT0] = ssat24(p0);
+            regs[POT1] = ssat24(p1);
+            regs[POT2] = ssat24(p2);
+
+            if (fv1->program)
+                fv1->program(fv1);
+
+            fv1->ptr--;
+            fv1->first = 0;
+
+            for (int n = 0; n < 2; n++)
+            {
+                const int32_t rate = regs[n ? SIN1_RATE : SIN0_RATE] >> 8;
+                auto &sin = fv1->sin[n];
+                sin.c = ssat24(sin.c + mul(sin.s, rate));
+                sin.s = ssat24(sin.s - mul(sin.c, rate));
+            }
+
+            for (int n = 0; n < 2; n++)
+            {
+                const int32_t max = RAMP_MAX >> (regs[n ? RMP1_RANGE : RMP0_RANGE] >> 21);
+                fv1->rmp[n] = (fv1->rmp[n] - (regs[n ? RMP1_RATE : RMP0_RATE] >> 12)) & max;
+            }
+
+            outL[i] = (float)regs[DACL] * (1.f / ONE);
+            outR[i] = (float)regs[DACR] * (1.f / ONE);
+        }
+    }
+
+    void fv1_fake_cv_trig(bool trig, float *in, unsigned int size)
+    {
+        static const uint32_t trig_wav[64] = {
+            0xBDC6EEEF, 0xBDC91111, 0xBDC91111, 0xBDC6EEEF, 0xBDC91111, 0xBDC6EEEF, 0xBDC91111, 0xBDC6EEEF,
+            0xBDC55555, 0xBDC6EEEF, 0xBDC6EEEF, 0xBDC55555, 0xBDC6EEEF, 0xBDC6EEEF, 0xBDC33333, 0xBDC55555,
+            0xBDC55555, 0xBDC6EEEF, 0xBDCB3333, 0xBDC55555, 0xBDC55555, 0xBDC6EEEF, 0xBDC91111, 0xBDC6EEEF,
+            0xBDC33333, 0xBDC33333, 0xBDCEEEEF, 0xBDC91111, 0xBDC6EEEF, 0xBDC91111, 0xBDC6EEEF, 0xBDC55555,
+            0xBDC91111, 0xBDC55555, 0xBDC6EEEF, 0xBDC91111, 0xBDC91111, 0xBDC55555, 0xBDC55555, 0xBDC91111,
+            0xBDC55555, 0xBDC6EEEF, 0xBDC91111, 0xBDC55555, 0xBDC91111, 0xBDC55555, 0xBDCB3333, 0xBDC91111,
+            0xBDC6EEEF, 0xBDC33333, 0xBDC91111, 0xBDCB3333, 0xBDCB3333, 0xBDC6EEEF, 0xBDCB3333, 0xBDC6EEEF,
+            0xBDCB3333, 0xBDC91111, 0xBDCB3333, 0xBDBD5555, 0xBDC6EEEF, 0xBDC91111, 0xBDC55555, 0xBDC91111,        };
+
+        for (unsigned int i = 0; i < size; i++)
+        {
+            if (trig)
+            {
+                in[i] = 1.f;
+            }
+            else
+            {
+                float f;
+                memcpy(&f, &trig_wav[prng() & 63], sizeof(f));
+                in[i] = f * 0.5f;
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+#
+# FV1_BNK0 flash blob (FV1emu engines, see src/fx_fv1.cxx)
+#
+#   fv1_bank.py convert FV1_BNK0 FV1_BNK0.new   # legacy bank -> indexed bank
+#   fv1_bank.py build out rom0.bin rom1.bin ... # indexed bank from FV1_ROM images (640 bytes)
+#   fv1_bank.py list FV1_BNK0
+#   fv1_bank.py extract FV1_BNK0 dir            # FV1_ROM images dir/00.bin ... (test/host/bench_fv1)
+#
+# Legacy bank: u8 count, u16 size, one raw LZMA2 stream with all FV1_ROMs.
+#
+# Indexed bank: "FV1I", u8 count, 3 bytes reserved, count index items
+# (u32 offset, u16 size, u8 props, u8 reserved, name[32], pot0[16], pot1[16], pot2[16])
+# followed by one raw LZMA2 stream per FV1_ROM (4K dictionary, as expected by xz_dec_lzma2).
+
+import lzma
+import os
+import struct
+import sys
+
+ROM_SIZE = 128 + 512
+MAGIC = b"FV1I"
+HEADER = struct.Struct("<4sB3x")
+ITEM = struct.Struct("<IHBx32s16s16s16s")
+FILTERS = [{"id": lzma.FILTER_LZMA2, "preset": 9 | lzma.PRESET_EXTREME, "dict_size": 4096}]
+
+
+def read_roms(bank):
+    if bank[:4] == MAGIC:
+        (count,) = HEADER.unpack_from(bank)[1:]
+        roms = []
+        for i in range(count):
+            offset, size = ITEM.unpack_from(bank, HEADER.size + i * ITEM.size)[:2]
+            dec = lzma.LZMADecompressor(lzma.FORMAT_RAW, filters=FILTERS)
+            roms.append(dec.decompress(bank[offset:offset + size], ROM_SIZE))
+        return roms
+
+    count, size = struct.unpack_from("<BH", bank)
+    dec = lzma.LZMADecompressor(lzma.FORMAT_RAW, filters=FILTERS)
+    data = dec.decompress(bank[3:3 + size], count * ROM_SIZE)
+    return [data[i * ROM_SIZE:(i + 1) * ROM_SIZE] for i in range(count)]
+
+
+def build(roms):
+    offset = HEADER.size + len(roms) * ITEM.size
+    index, chunks = b"", b""
+    for rom in roms:
+        assert len(rom) == ROM_SIZE
+        chunk = lzma.compress(rom, format=lzma.FORMAT_RAW, filters=FILTERS)
+        index += ITEM.pack(offset + len(chunks), len(chunk), rom[0], rom[1:33], rom[33:49], rom[49:65], rom[65:81])
+        chunks += chunk
+
+    return HEADER.pack(MAGIC, len(roms)) + index + chunks
+
+
+def cstr(b):
+    return b.split(b"\0")[0].decode("latin-1")
+
+
+def main(argv):
+    if len(argv) == 4 and argv[1] == "convert":
+        roms = read_roms(open(argv[2], "rb").read())
+        open(argv[3], "wb").write(build(roms))
+    elif len(argv) >= 4 and argv[1] == "build":
+        roms = [open(f, "rb").read() for f in argv[3:]]
+        open(argv[2], "wb").write(build(roms))
+    elif len(argv) == 3 and argv[1] == "list":
+        for i, rom in enumerate(read_roms(open(argv[2], "rb").read())):
+            print("%2d %-32s %-16s %-16s %-16s" % (i, cstr(rom[1:33]), cstr(rom[33:49]), cstr(rom[49:65]), cstr(rom[65:81])))
+    elif len(argv) == 4 and argv[1] == "extract":
+        os.makedirs(argv[3], exist_ok=True)
+        for i, rom in enumerate(read_roms(open(argv[2], "rb").read())):
+            open(os.path.join(argv[3], "%02d.bin" % i), "wb").write(rom)
+    else:
+        print("usage: fv1_bank.py convert in out | build out rom... | list bank | extract bank dir", file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
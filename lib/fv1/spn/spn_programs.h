@@ -0,0 +1,263 @@
+// generated by lib/fv1/spn_compile.py, do not edit
+
+// dance_ir_h_l.spn
+static const Instr dance_ir_h_l_spn[] = {
+    {RDAX, 16, 16768768, 0},
+    {WRAX, 34, 0, 0},
+    {RDAX, 16, -8388608, 0},
+    {SOF, 8388608, 8380160, 0},
+    {SOF, 16768768, 0, 0},
+    {WRAX, 33, 0, 0},
+    {RDAX, 16, 8388608, 0},
+    {WRAX, 32, 8388608, 0},
+    {SOF, 8388608, -4194304, 0},
+    {SKP, 2, 2, 0},
+    {SOF, 0, 4194304, 0},
+    {WRAX, 32, 0, 0},
+    {AND, 0, 0, 0},
+    {RDAX, 17, 8388608, 0},
+    {SOF, 4194304, -4194304, 0},
+    {EXP, 8388608, 0, 0},
+    {WRAX, 43, 0, 0},
+    {RDAX, 18, 8388608, 0},
+    {SOF, 4194304, -4194304, 0},
+    {EXP, 8388608, 0, 0},
+    {WRAX, 44, 0, 0},
+    {RDAX, 17, -8388608, 0},
+    {SOF, 8388608, 8380160, 0},
+    {WRAX, 45, 8388608, 0},
+    {MULX, 45, 0, 0},
+    {MULX, 45, 0, 0},
+    {WRAX, 50, 0, 0},
+    {RDAX, 18, 8388608, 0},
+    {MULX, 18, 0, 0},
+    {MULX, 18, 0, 0},
+    {MULX, 18, 0, 0},
+    {WRAX, 51, 0, 0},
+    {RDAX, 20, 2097152, 0},
+    {RDAX, 21, 2097152, 0},
+    {MULX, 33, 0, 0},
+    {RDA, 202, 5029888, 0},
+    {WRAP, 0, -5038080, 0},
+    {RDA, 744, 5029888, 0},
+    {WRAP, 203, -5038080, 0},
+    {RDA, 1902, 5029888, 0},
+    {WRAP, 745, -5038080, 0},
+    {RDA, 3806, 5029888, 0},
+    {WRAP, 1903, -5038080, 0},
+    {WRAX, 45, 0, 0},
+    {RDA, 26831, 8388608, 0},
+    {MULX, 32, 0, 0},
+    {RDAX, 45, 8388608, 0},
+    {RDA, 6011, 5029888, 0},
+    {WRAP, 3807, -5038080, 0},
+    {RDA, 9313, 5029888, 0},
+    {WRAP, 6012, -5038080, 0},
+    {WRA, 9314, 0, 0},
+    {RDA, 13770, 8388608, 0},
+    {MULX, 32, 0, 0},
+    {RDAX, 45, 8388608, 0},
+    {RDA, 17303, 5029888, 0},
+    {WRAP, 13771, -5038080, 0},
+    {RDA, 20505, 5029888, 0},
+    {WRAP, 17304, -5038080, 0},
+    {WRA, 20506, 0, 0},
+    {RDAX, 20, -8388608, 0},
+    {RDA, 9314, 12582912, 0},
+    {MULX, 16, 0, 0},
+    {RDAX, 20, 8388608, 0},
+    {WRAX, 46, 0, 0},
+    {RDAX, 21, -8388608, 0},
+    {RDA, 20506, 12582912, 0},
+    {MULX, 16, 0, 0},
+    {RDAX, 21, 8388608, 0},
+    {WRAX, 47, 0, 0},
+    {RDAX, 35, 8388608, 0},
+    {MULX, 43, 0, 0},
+    {RDAX, 36, 8388608, 0},
+    {WRAX, 36, -8388608, 0},
+    {RDAX, 35, -1677824, 0},
+    {RDAX, 46, 8388608, 0},
+    {WRAX, 48, 8388608, 0},
+    {MULX, 43, 0, 0},
+    {RDAX, 35, 8388608, 0},
+    {WRAX, 35, 0, 0},
+    {RDAX, 39, 8388608, 0},
+    {MULX, 43, 0, 0},
+    {RDAX, 40, 8388608, 0},
+    {WRAX, 40, -8388608, 0},
+    {RDAX, 39, -1677824, 0},
+    {RDAX, 47, 8388608, 0},
+    {WRAX, 49, 8388608, 0},
+    {MULX, 43, 0, 0},
+    {RDAX, 39, 8388608, 0},
+    {WRAX, 39, 0, 0},
+    {RDAX, 48, -8388608, 0},
+    {RDAX, 46, 8388608, 0},
+    {MULX, 50, 0, 0},
+    {RDAX, 48, 8388608, 0},
+    {WRAX, 48, 0, 0},
+    {RDAX, 49, -8388608, 0},
+    {RDAX, 47, 8388608, 0},
+    {MULX, 50, 0, 0},
+    {RDAX, 49, 8388608, 0},
+    {WRAX, 49, 0, 0},
+    {RDAX, 37, 8388608, 0},
+    {MULX, 44, 0, 0},
+    {RDAX, 38, 8388608, 0},
+    {WRAX, 38, -8388608, 0},
+    {RDAX, 37, -1677824, 0},
+    {RDAX, 48, 8388608, 0},
+    {MULX, 44, 0, 0},
+    {RDAX, 37, 8388608, 0},
+    {WRAX, 37, 0, 0},
+    {RDAX, 41, 8388608, 0},
+    {MULX, 44, 0, 0},
+    {RDAX, 42, 8388608, 0},
+    {WRAX, 42, -8388608, 0},
+    {RDAX, 41, -1677824, 0},
+    {RDAX, 49, 8388608, 0},
+    {MULX, 44, 0, 0},
+    {RDAX, 41, 8388608, 0},
+    {WRAX, 41, 0, 0},
+    {RDAX, 38, -8388608, 0},
+    {RDAX, 48, 8388608, 0},
+    {MULX, 51, 0, 0},
+    {RDAX, 38, 8388608, 0},
+    {WRAX, 22, 0, 0},
+    {RDAX, 42, -8388608, 0},
+    {RDAX, 49, 8388608, 0},
+    {MULX, 51, 0, 0},
+    {RDAX, 42, 8388608, 0},
+    {WRAX, 23, 0, 0},
+    {END, 0, 0, 0},
+};
+
+// OEM1_4.spn
+static const Instr OEM1_4_spn[] = {
+    {SKP, 16, 1, 0},
+    {WLDR, 0, 0, 0},
+    {RDAX, 20, 2097152, 0},
+    {RDAX, 21, 2097152, 0},
+    {WRA, 0, 0, 0},
+    {CHO_RDA, 2, 6, 0},
+    {CHO_RDA, 2, 0, 1},
+    {WRA, 4101, 0, 0},
+    {CHO_RDAL, 2, 0, 0},
+    {RDAX, 17, -4194304, 0},
+    {WRAX, 4, 0, 0},
+    {RDAX, 16, 8388608, 0},
+    {AND, 15728640, 0, 0},
+    {SOF, 8388608, -7864320, 0},
+    {SKP, 2, 38, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 37, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 36, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 35, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 34, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 33, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 32, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 31, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 30, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 29, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 28, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 27, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 26, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 25, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 24, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 23, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 22, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 21, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 20, 0},
+    {SOF, 8388608, 524288, 0},
+    {SKP, 2, 19, 0},
+    {RDA, 18435, 3350528, 0},
+    {RDA, 18124, 4194304, 0},
+    {RDA, 17609, 3350528, 0},
+    {RDA, 17202, 4194304, 0},
+    {RDA, 16861, 4194304, 0},
+    {RDA, 16221, 3350528, 0},
+    {RDA, 15866, 4194304, 0},
+    {RDA, 15413, 4194304, 0},
+    {RDA, 14851, 4194304, 0},
+    {RDA, 14313, 4194304, 0},
+    {RDA, 13806, 4194304, 0},
+    {RDA, 13468, 4194304, 0},
+    {RDA, 13006, 3350528, 0},
+    {RDA, 12676, 4194304, 0},
+    {RDA, 12316, 4194304, 0},
+    {RDA, 11513, 3350528, 0},
+    {RDA, 11245, 4194304, 0},
+    {RDA, 10614, 4194304, 0},
+    {RDA, 9923, 4194304, 0},
+    {RDA, 9421, 4194304, 0},
+    {RDA, 9239, 4194304, 0},
+    {RDA, 8677, 4194304, 0},
+    {RDA, 8008, 3350528, 0},
+    {RDA, 7521, 4194304, 0},
+    {RDA, 7075, 4194304, 0},
+    {RDA, 6631, 4194304, 0},
+    {RDA, 6211, 4194304, 0},
+    {RDA, 5441, 4194304, 0},
+    {RDA, 5024, 4194304, 0},
+    {RDA, 4601, 4194304, 0},
+    {RDA, 4101, 5029888, 0},
+    {WRAX, 33, 8388608, 0},
+    {RDA, 19336, 5029888, 0},
+    {WRAP, 19102, -5038080, 0},
+    {RDA, 19783, 5029888, 0},
+    {WRAP, 19337, -5038080, 0},
+    {RDA, 20336, 5029888, 0},
+    {WRAP, 19784, -5038080, 0},
+    {WRAX, 22, 0, 0},
+    {RDAX, 33, 8388608, 0},
+    {RDA, 20538, 5029888, 0},
+    {WRAP, 20337, -5038080, 0},
+    {RDA, 20928, 5029888, 0},
+    {WRAP, 20539, -5038080, 0},
+    {RDA, 21556, 5029888, 0},
+    {WRAP, 20929, -5038080, 0},
+    {WRAX, 23, 0, 0},
+    {RDA, 6601, -8388608, 0},
+    {RDFX, 34, 4194304, 0},
+    {WRHX, 34, -8388608, 0},
+    {MULX, 18, 0, 0},
+    {RDA, 6601, 8388608, 0},
+    {WRA, 6601, 0, 0},
+    {RDA, 8601, -8388608, 0},
+    {RDFX, 35, 3355392, 0},
+    {WRHX, 35, -8388608, 0},
+    {MULX, 18, 0, 0},
+    {RDA, 8601, 8388608, 0},
+    {WRA, 8601, 0, 0},
+    {RDA, 11101, -8388608, 0},
+    {RDFX, 34, 2516480, 0},
+    {WRHX, 34, -8388608, 0},
+    {MULX, 18, 0, 0},
+    {RDA, 11101, 8388608, 0},
+    {WRA, 11101, 0, 0},
+    {RDA, 14101, -8388608, 0},
+    {RDFX, 34, 1677568, 0},
+    {WRHX, 34, -8388608, 0},
+    {MULX, 18, 0, 0},
+    {RDA, 14101, 8388608, 0},
+    {WRA, 14101, 0, 0},
+    {END, 0, 0, 0},
+};
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+#
+# SpinASM (.spn) -> decoded FV1.cc instruction table (host build of fv1_programs[], see FV1.cc)
+#
+#   spn_compile.py spn/dance_ir_h_l.spn spn/OEM1_4.spn > spn/spn_programs.h
+#
+# The compiled programs in FV1.S keep one more bit of the coefficients than the FV-1 instruction
+# words: (int)(C * 2^23) with the lower 8 bits cleared (13 bits for RDA/WRA/WRAP/RMPA). The
+# table uses the same constants, so the host output is bit exact with FV1.S (test/host/fv1_ref.py).
+
+import os
+import re
+import sys
+
+ONE = 1 << 23
+
+REGS = {
+    "sin0_rate": 0x00, "sin0_range": 0x01, "sin1_rate": 0x02, "sin1_range": 0x03,
+    "rmp0_rate": 0x04, "rmp0_range": 0x05, "rmp1_rate": 0x06, "rmp1_range": 0x07,
+    "pot0": 0x10, "pot1": 0x11, "pot2": 0x12,
+    "adcl": 0x14, "adcr": 0x15, "dacl": 0x16, "dacr": 0x17, "addr_ptr": 0x18,
+}
+REGS.update({"reg%d" % i: 0x20 + i for i in range(32)})
+
+CONSTANTS = {
+    # SKP
+    "run": 0x10, "zrc": 0x08, "zro": 0x04, "gez": 0x02, "neg": 0x01,
+    # CHO
+    "sin": 0x00, "cos": 0x01, "reg": 0x02, "compc": 0x04, "compa": 0x08, "rptr2": 0x10, "na": 0x20,
+    "sin0": 0, "sin1": 1, "rmp0": 2, "rmp1": 3,
+}
+
+RAMP_AMP = {4096: 0, 2048: 1, 1024: 2, 512: 3}
+
+
+def coeff(c, bits):
+    """S.23 constant with the lower bits cleared (rounds towards -inf like the FV1.S constants)"""
+    return int(c * ONE) & ~((1 << bits) - 1)
+
+
+class Compiler:
+    def __init__(self):
+        self.symbols = dict(REGS)
+        self.symbols.update(CONSTANTS)
+        self.mem_top = 0
+        self.labels = {}
+        self.lines = []
+
+    def value(self, expr):
+        expr = expr.strip().lower()
+        expr = re.sub(r"%([01_]+)", lambda m: str(int(m.group(1).replace("_", ""), 2)), expr)
+        expr = re.sub(r"\$([0-9a-f]+)", lambda m: str(int(m.group(1), 16)), expr)
+        expr = re.sub(r"([a-z_]\w*)([#^]?)", lambda m: "(%s)" % self.symbol(m.group(1), m.group(2)), expr)
+        return eval(expr, {"__builtins__": {}})
+
+    def symbol(self, name, suffix):
+        v = self.symbols[name]
+        if suffix:
+            base, size = v
+            return base + (size if suffix == "#" else size // 2)
+        return v[0] if isinstance(v, tuple) else v
+
+    def parse(self, text):
+        for line in text.splitlines():
+            line = line.split(";")[0].strip()
+            if not line:
+                continue
+
+            m = re.match(r"^(\w+)\s*:\s*(.*)$", line)
+            if m:
+                self.labels[m.group(1).lower()] = len(self.lines)
+                line = m.group(2).strip()
+                if not line:
+                    continue
+
+            op, args = (re.split(r"\s+", line, 1) + [""])[:2]
+            op = op.lower()
+            args = [a.strip() for a in args.split(",")] if args.strip() else []
+
+            if op == "equ":
+                name, expr = args[0].split(None, 1) if len(args) == 1 else (args[0], args[1])
+                self.symbols[name.lower()] = self.value(expr)
+            elif op == "mem":
+                name, size = args[0].split(None, 1) if len(args) == 1 else (args[0], args[1])
+                size = int(self.value(size))
+                self.symbols[name.lower()] = (self.mem_top, size)
+                self.mem_top += size + 1
+            else:
+                self.lines.append((op, args))
+
+        if self.mem_top > 32768:
+            raise ValueError("delay memory %d > 32768" % self.mem_top)
+
+    def compile(self):
+        out = []
+        for n, (op, args) in enumerate(self.lines):
+            v = self.value
+            if op in ("rda", "wra", "wrap"):
+                out.append((op.upper(), int(v(args[0])) & 0xFFFF, coeff(v(args[1]), 13), 0))
+            elif op == "rmpa":
+                out.append(("RMPA", coeff(v(args[0]), 13), 0, 0))
+            elif op in ("rdax", "rdfx", "wrax", "wrhx", "wrlx", "maxx"):
+                out.append((op.upper(), int(v(args[0])), coeff(v(args[1]), 8), 0))
+            elif op == "ldax":
+                out.append(("RDFX", int(v(args[0])), 0, 0))
+            elif op == "absa":
+                out.append(("MAXX", 0, 0, 0))
+            elif op == "mulx":
+                out.append(("MULX", int(v(args[0])), 0, 0))
+            elif op in ("sof", "exp"):
+                out.append((op.upper(), coeff(v(args[0]), 8), coeff(v(args[1]), 8), 0))
+            elif op == "log":
+                out.append(("LOG", coeff(v(args[0]), 8), coeff(v(args[1]) / 16, 8), 0))
+            elif op in ("and", "or", "xor"):
+                out.append((op.upper(), int(v(args[0])) & 0xFFFFFF, 0, 0))
+            elif op == "clr":
+                out.append(("AND", 0, 0, 0))
+            elif op == "not":
+                out.append(("XOR", 0xFFFFFF, 0, 0))
+            elif op == "skp":
+                target = args[1].lower()
+                skip = self.labels[target] - n - 1 if target in self.labels else int(v(target))
+                out.append(("SKP", int(v(args[0])), skip, 0))
+            elif op == "wlds":
+                out.append(("WLDS", int(v(args[0])), int(v(args[1])) & 0x1FF, int(v(args[2])) & 0x7FFF))
+            elif op == "wldr":
+                out.append(("WLDR", int(v(args[0])) & 1, int(v(args[1])) & 0xFFFF, RAMP_AMP[int(v(args[2]))]))
+            elif op == "jam":
+                out.append(("JAM", int(v(args[0])) & 1, 0, 0))
+            elif op == "cho":
+                mode = args[0].lower()
+                lfo = int(v(args[1]))
+                flags = int(v(args[2])) if len(args) > 2 else 0
+                if mode == "rda":
+                    out.append(("CHO_RDA", lfo, flags, int(v(args[3])) & 0xFFFF))
+                elif mode == "rdal":
+                    out.append(("CHO_RDAL", lfo, flags, 0))
+                else:
+                    raise ValueError("cho %s: not supported" % mode)
+            else:
+                raise ValueError("%s: unknown instruction" % op)
+
+        if len(out) > 128:
+            raise ValueError("%d instructions > 128" % len(out))
+
+        return out + [("END", 0, 0, 0)]
+
+
+def main(argv):
+    if len(argv) < 2:
+        print("usage: spn_compile.py program.spn ... > spn_programs.h", file=sys.stderr)
+        return 1
+
+    print("// generated by lib/fv1/spn_compile.py, do not edit")
+    for path in argv[1:]:
+        c = Compiler()
+        c.parse(open(path).read())
+        name = re.sub(r"\W", "_", os.path.basename(path))
+        print()
+        print("// %s" % os.path.basename(path))
+        print("static const Instr %s[] = {" % name)
+        for op, a, b, d in c.compile():
+            print("    {%s, %d, %d, %d}," % (op, a, b, d))
+        print("};")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
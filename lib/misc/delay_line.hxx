@@ -0,0 +1,158 @@
+
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+// Delay lines with Write(float) / Read / ReadHermite (same API as stmlib::DelayLine), samples are
+// stored as bits-bit integers. Line provides at(i) (sample i as integer) and the max_delay.
+template <class Line, size_t max_delay, int bits>
+struct DelayLineBase
+{
+    static constexpr size_t LENGTH = max_delay;
+    static constexpr float SCALE = 1 << (bits - 1);
+    static constexpr int32_t MAX = (1 << (bits - 1)) - 1;
+
+    size_t write_ptr_;
+
+    inline size_t wrap(size_t i) const
+    {
+        return i >= max_delay ? i - max_delay : i;
+    }
+
+    // clamp + round half away from zero: a float compare, add and vcvt on the M7 - lrintf may end up
+    // as a newlib call per sample
+    static inline int32_t quantize(float sample)
+    {
+        float v = sample * SCALE;
+        v = v > MAX ? MAX : (v < -MAX - 1 ? -MAX - 1 : v);
+        return (int32_t)(v + copysignf(0.5f, v));
+    }
+
+    inline float Read(size_t delay) const
+    {
+        return line().at(wrap(write_ptr_ + delay)) * (1.0f / SCALE);
+    }
+
+    // 1 <= delay < max_delay - 2
+    inline float ReadHermite(float delay) const
+    {
+        const size_t delay_integral = static_cast<size_t>(delay);
+        const float f = delay - static_cast<float>(delay_integral);
+        const size_t t = wrap(write_ptr_ + delay_integral);
+        const float xm1 = line().at(t == 0 ? max_delay - 1 : t - 1);
+        const float x0 = line().at(t);
+        const float x1 = line().at(wrap(t + 1));
+        const float x2 = line().at(wrap(t + 2));
+        const float c = (x1 - xm1) * 0.5f;
+        const float v = x0 - x1;
+        const float w = c + v;
+        const float a = w + v + (x2 - x0) * 0.5f;
+        const float b_neg = w + a;
+        return ((((a * f) - b_neg) * f + c) * f + x0) * (1.0f / SCALE);
+    }
+
+protected:
+    inline void advance()
+    {
+        write_ptr_ = (write_ptr_ == 0 ? max_delay : write_ptr_) - 1;
+    }
+
+private:
+    inline const Line &line() const
+    {
+        return *static_cast<const Line *>(this);
+    }
+};
+
+// 16-bit samples, 1s @48kHz = 96KB
+template <size_t max_delay>
+struct DelayLine16 : DelayLineBase<DelayLine16<max_delay>, max_delay, 16>
+{
+    int16_t line_[max_delay];
+
+    void Init()
+    {
+        memset(line_, 0, sizeof(line_));
+        this->write_ptr_ = 0;
+    }
+
+    inline int32_t at(size_t i) const
+    {
+        return line_[i];
+    }
+
+    inline void Write(float sample)
+    {
+        line_[this->write_ptr_] = this->quantize(sample);
+        this->advance();
+    }
+};
+
+// 12-bit samples, two samples packed in 3 bytes, for long delays: 64000 samples (1.33s @48kHz) need
+// as much memory as a 1s DelayLine16<48000>, at 24dB less resolution.
+template <size_t max_delay>
+struct DelayLine12 : DelayLineBase<DelayLine12<max_delay>, max_delay, 12>
+{
+    static_assert((max_delay & 1) == 0, "");
+
+    uint8_t line_[max_delay / 2 * 3];
+
+    void Init()
+    {
+        memset(line_, 0, sizeof(line_));
+        this->write_ptr_ = 0;
+    }
+
+    inline int32_t at(size_t i) const
+    {
+        const uint8_t *p = &line_[(i >> 1) * 3];
+        int32_t v = (i & 1) ? (p[1] >> 4) | (p[2] << 4) : p[0] | ((p[1] & 0x0F) << 8);
+        return (int32_t)((uint32_t)v << 20) >> 20;
+    }
+
+    inline void Write(float sample)
+    {
+        const int32_t v = this->quantize(sample);
+
+        uint8_t *p = &line_[(this->write_ptr_ >> 1) * 3];
+        if (this->write_ptr_ & 1)
+        {
+            p[1] = (p[1] & 0x0F) | ((v << 4) & 0xF0);
+            p[2] = v >> 4;
+        }
+        else
+        {
+            p[0] = v;
+            p[1] = (p[1] & 0xF0) | ((v >> 8) & 0x0F);
+        }
+
+        this->advance();
+    }
+};
@@ -75,7 +75,7 @@ static inline int32_t signed_multiply_32x16b(int32_t a, uint32_t b)
 	int32_t out;
 	asm volatile("smulwb %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return ((int64_t)a * (int16_t)(b & 0xFFFF)) >> 16;
 #endif
 }
@@ -88,7 +88,7 @@ static inline int32_t signed_multiply_32x16t(int32_t a, uint32_t b)
 	int32_t out;
 	asm volatile("smulwt %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return ((int64_t)a * (int16_t)(b >> 16)) >> 16;
 #endif
 }
@@ -101,7 +101,7 @@ static inline int32_t multiply_32x32_rshift32(int32_t a, int32_t b)
 	int32_t out;
 	asm volatile("smmul %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return ((int64_t)a * (int64_t)b) >> 32;
 #endif
 }
@@ -114,7 +114,7 @@ static inline int32_t multiply_32x32_rshift32_rounded(int32_t a, int32_t b)
 	int32_t out;
 	asm volatile("smmulr %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return (((int64_t)a * (int64_t)b) + 0x8000000) >> 32;
 #endif
 }
@@ -127,7 +127,7 @@ static inline int32_t multiply_accumulate_32x32_rshift32_rounded(int32_t sum, in
 	int32_t out;
 	asm volatile("smmlar %0, %2, %3, %1" : "=r" (out) : "r" (sum), "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return sum + ((((int64_t)a * (int64_t)b) + 0x8000000) >> 32);
 #endif
 }
@@ -140,7 +140,7 @@ static inline int32_t multiply_subtract_32x32_rshift32_rounded(int32_t sum, int3
 	int32_t out;
 	asm volatile("smmlsr %0, %2, %3, %1" : "=r" (out) : "r" (sum), "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return sum - ((((int64_t)a * (int64_t)b) + 0x8000000) >> 32);
 #endif
 }
@@ -154,7 +154,7 @@ static inline uint32_t pack_16t_16t(int32_t a, int32_t b)
 	int32_t out;
 	asm volatile("pkhtb %0, %1, %2, asr #16" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return (a & 0xFFFF0000) | ((uint32_t)b >> 16);
 #endif
 }
@@ -167,7 +167,7 @@ static inline uint32_t pack_16t_16b(int32_t a, int32_t b)
 	int32_t out;
 	asm volatile("pkhtb %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return (a & 0xFFFF0000) | (b & 0x0000FFFF);
 #endif
 }
@@ -180,7 +180,7 @@ static inline uint32_t pack_16b_16b(int32_t a, int32_t b)
 	int32_t out;
 	asm volatile("pkhbt %0, %1, %2, lsl #16" : "=r" (out) : "r" (b), "r" (a));
 	return out;
-#elif defined(KINETISL)
+#else //[eh2k] portable fallback (host build), was: defined(KINETISL)
 	return (a << 16) | (b & 0x0000FFFF);
 #endif
 }
@@ -0,0 +1,236 @@
+
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+// Fixed size LRU cache without heap allocations (linear search, meant for small N)
+template <typename K, typename V, size_t N>
+struct LRUCache
+{
+    struct Entry
+    {
+        K key;
+        uint32_t used = 0; // 0 == empty
+        V value;
+    } entries[N];
+
+    uint32_t clock = 0;
+
+    V *find(const K &key)
+    {
+        for (auto &e : entries)
+        {
+            if (e.used && e.key == key)
+            {
+                e.used = ++clock;
+                return &e.value;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Returns the slot for key (least recently used entry is evicted), the caller fills the value
+    V *insert(const K &key)
+    {
+        Entry *slot = &entries[0];
+        for (auto &e : entries)
+        {
+            if (e.used < slot->used)
+                slot = &e;
+        }
+
+        slot->key = key;
+        slot->used = ++clock;
+        return &slot->value;
+    }
+
+    // Two step insert for values that take a while to fill: the slot is invisible to find() until
+    // commit(value), a reader never sees a half written value
+    V *reserve(const K &key)
+    {
+        V *value = insert(key);
+        commit(value, 0);
+        return value;
+    }
+
+    void commit(V *value)
+    {
+        commit(value, ++clock);
+    }
+
+    void clear()
+    {
+        for (auto &e : entries)
+            e.used = 0;
+    }
+
+private:
+    void commit(V *value, uint32_t used)
+    {
+        for (auto &e : entries)
+            if (&e.value == value)
+                e.used = used;
+    }
+};
+
+// Variable sized entries (up to N) in a fixed byte pool, used as a ring: a new entry is written in
+// place at the head and becomes visible with commit(). As it grows, the entries in its way (the
+// oldest ones) are dropped - eviction is O(1), no data is moved. Each entry is contiguous: a new
+// entry starts at 0 if the largest entry so far does not fit behind the head, or moves there (once)
+// when it reaches the end of the pool. With all N slots in use the least recently used is dropped.
+template <typename K, size_t N>
+struct LRUPool
+{
+    struct Entry
+    {
+        K key;
+        uint32_t used = 0; // 0 == empty
+        uint32_t offset = 0;
+        uint32_t len = 0;
+    } entries[N];
+
+    uint8_t *pool = nullptr;
+    size_t size = 0;
+    size_t head = 0;    // the pending entry starts at head
+    size_t limit = 0;   // pending bytes up to limit are free
+    size_t pending_len = 0;
+    size_t max_len = 0; // largest committed entry
+    uint32_t clock = 0;
+    K pending_key;
+
+    void init(uint8_t *pool, size_t size)
+    {
+        this->pool = pool;
+        this->size = size;
+        clear();
+    }
+
+    const uint8_t *find(const K &key, size_t *len)
+    {
+        for (auto &e : entries)
+        {
+            if (e.used && e.key == key)
+            {
+                e.used = ++clock;
+                *len = e.len;
+                return pool + e.offset;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Starts a new entry (replaces a pending one), pending() is writable up to the length passed to grow()
+    void reserve(const K &key)
+    {
+        pending_key = key;
+
+        for (auto &e : entries)
+            if (e.used && e.key == key)
+                e.used = 0;
+
+        if (size - head < max_len)
+            head = 0;
+
+        limit = head;
+        pending_len = 0;
+    }
+
+    uint8_t *pending()
+    {
+        return pool + head;
+    }
+
+    // Drops the entries in the way until the pending entry has len bytes, false if len > size
+    bool grow(size_t len)
+    {
+        if (head + len <= limit)
+        {
+            pending_len = len > pending_len ? len : pending_len;
+            return true;
+        }
+
+        if (len > size)
+            return false;
+
+        if (head + len > size)
+        {
+            drop(0, len);
+            memmove(pool, pool + head, pending_len);
+            head = 0;
+        }
+
+        drop(head, head + len);
+
+        limit = size;
+        for (auto &e : entries)
+            if (e.used && e.offset >= head && e.offset < limit)
+                limit = e.offset;
+
+        pending_len = len > pending_len ? len : pending_len;
+        return true;
+    }
+
+    void commit(size_t len)
+    {
+        Entry *slot = &entries[0];
+        for (auto &e : entries)
+            if (e.used == 0 || e.used < slot->used)
+                slot = &e;
+
+        slot->key = pending_key;
+        slot->used = ++clock;
+        slot->offset = head;
+        slot->len = len;
+        head += len;
+        limit = head;
+        pending_len = 0;
+        max_len = len > max_len ? len : max_len;
+    }
+
+    void clear()
+    {
+        for (auto &e : entries)
+            e.used = 0;
+        head = 0;
+        limit = 0;
+        pending_len = 0;
+        max_len = 0;
+    }
+
+private:
+    // entries overlapping [from, to), empty ones at [from, to) too
+    void drop(size_t from, size_t to)
+    {
+        for (auto &e : entries)
+            if (e.used && (e.offset >= from ? e.offset < to : e.offset + e.len > from))
+                e.used = 0;
+    }
+};
@@ -35,7 +35,7 @@ struct WhiteNoise
 
     WhiteNoise()
     {
-        seed = (uint32_t)(void*)this;
+        seed = (uint32_t)(uintptr_t)this;
     }
 
     int32_t next() // 0 to INT32_MAX
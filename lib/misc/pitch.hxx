@@ -0,0 +1,108 @@
+
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+// Pitch conversion without powf/expf: exp2 with a 64 segment table per octave and linear
+// interpolation (< 0.03 cent error), the octave goes directly into the float exponent.
+// The batch version is a branch free loop over the table.
+namespace pitch
+{
+    constexpr float exp2_table[65] = {
+        1.000000000f, 1.010889286f, 1.021897149f, 1.033024879f,
+        1.044273782f, 1.055645178f, 1.067140401f, 1.078760798f,
+        1.090507733f, 1.102382583f, 1.114386743f, 1.126521619f,
+        1.138788635f, 1.151189230f, 1.163724859f, 1.176396992f,
+        1.189207115f, 1.202156731f, 1.215247360f, 1.228480536f,
+        1.241857812f, 1.255380757f, 1.269050957f, 1.282870016f,
+        1.296839555f, 1.310961212f, 1.325236643f, 1.339667524f,
+        1.354255547f, 1.369002423f, 1.383909882f, 1.398979673f,
+        1.414213562f, 1.429613338f, 1.445180807f, 1.460917794f,
+        1.476826146f, 1.492907728f, 1.509164428f, 1.525598151f,
+        1.542210825f, 1.559004400f, 1.575980845f, 1.593142151f,
+        1.610490332f, 1.628027422f, 1.645755478f, 1.663676580f,
+        1.681792831f, 1.700106354f, 1.718619298f, 1.737333835f,
+        1.756252160f, 1.775376493f, 1.794709075f, 1.814252176f,
+        1.834008086f, 1.853979125f, 1.874167634f, 1.894575982f,
+        1.915206561f, 1.936061793f, 1.957144124f, 1.978456026f,
+        2.000000000f,
+    };
+
+    // 2^x for -126 < x < 128
+    inline float exp2(float x)
+    {
+        const float t = (x + 128.f) * 64.f; // positive, truncation = floor
+        const int32_t i = (int32_t)t;
+        const int32_t k = i & 63;
+        const float m = exp2_table[k] + (exp2_table[k + 1] - exp2_table[k]) * (t - (float)i);
+
+        const int32_t bits = ((i >> 6) - 128 + 127) << 23;
+        float scale;
+        memcpy(&scale, &bits, sizeof(scale));
+        return m * scale;
+    }
+
+    inline void exp2(const float *in, float *out, size_t size)
+    {
+        for (size_t i = 0; i < size; i++)
+            out[i] = exp2(in[i]);
+    }
+
+    inline float semitones_to_ratio(float semitones)
+    {
+        return exp2(semitones * (1.f / 12.f));
+    }
+
+    inline float note_to_frequency(float note, float a4 = 440.f)
+    {
+        return a4 * exp2((note - 69.f) * (1.f / 12.f));
+    }
+
+    // Remembers the last conversion, unchanged pitch (the usual case between two blocks)
+    // returns the cached value without recalculation.
+    template <float (*F)(float)>
+    struct Cached
+    {
+        float in = -1e9f;
+        float out = 0;
+
+        inline float operator()(float x)
+        {
+            if (x != in)
+            {
+                in = x;
+                out = F(x);
+            }
+            return out;
+        }
+    };
+
+    using CachedRatio = Cached<semitones_to_ratio>;
+    using CachedExp2 = Cached<static_cast<float (*)(float)>(exp2)>;
+} // namespace pitch
@@ -1,6 +1,7 @@
 #ifndef rosic_Open303_h
 #define rosic_Open303_h
 
+#include "misc/pitch.hxx" //[eh2k]
 #include "rosic_MidiNoteEvent.h"
 #include "rosic_BlendOscillator.h"
 #include "rosic_BiquadFilter.h"
@@ -379,8 +380,12 @@ namespace rosic
     tmp2 = n2 * rc2.getSample(tmp2);  
     tmp1 = envScaler * ( tmp1 - envOffset );  // seems not to work yet
     tmp2 = accentGain*tmp2;
-    real_t instCutoff = cutoff * pow(2.0, tmp1+tmp2);
-    filter.setCutoff(instCutoff);
+    //[eh2k]> pow(2.0, x) was evaluated in double, the filter coefficients were recalculated every
+    // sample - now only if the clipped cutoff moved by more than ~1.7 cents (1/1024)
+    real_t instCutoff = clip(cutoff * pitch::exp2(tmp1+tmp2), (real_t)200.0, (real_t)20000.0);
+    if( fabs(instCutoff - filter.getCutoff()) > instCutoff * (1.0f / 1024) )
+      filter.setCutoff(instCutoff);
+    //<[eh2k]
 
     real_t ampEnvOut = ampEnv.getSample();
     //ampEnvOut += 0.45*filterEnvOut + accentGain*6.8*filterEnvOut; 
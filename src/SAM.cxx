@@ -26,6 +26,7 @@
 #include "machine.h"
 #include "stmlib/dsp/dsp.h"
 #include "base/SampleEngine.hxx"
+#include "misc/lru_cache.hxx"
 #include <ctype.h>
 #include <stdlib.h>
 
@@ -39,30 +40,61 @@ using namespace machine;
 
 struct SAM : public SampleEngine
 {
-    uint8_t _buffer[48000];
+    static constexpr int RND = 6;
+    static constexpr int RENDER_CHUNK = 256; // SAM samples (22050Hz) per block, ~10x playback speed
+
     tsample_spec<uint8_t> _sounds[7] = {
-        {"electro", _buffer, 0, 22050, 0},
-        {"techno", _buffer, 0, 22050, 0},
-        {"modular", _buffer, 0, 22050, 0},
-        {"synthesizer", _buffer, 0, 22050, 0},
-        {"oscillator", _buffer, 0, 22050, 0},
-        {"eurorack", _buffer, 0, 22050, 0},
-        {"RND_1-9", _buffer, 0, 22050, 0},
+        {"electro", nullptr, 0, 22050, 0},
+        {"techno", nullptr, 0, 22050, 0},
+        {"modular", nullptr, 0, 22050, 0},
+        {"synthesizer", nullptr, 0, 22050, 0},
+        {"oscillator", nullptr, 0, 22050, 0},
+        {"eurorack", nullptr, 0, 22050, 0},
+        {"RND_1-9", nullptr, 0, 22050, 0},
     };
 
-    uint8_t _ti = 0;
+    struct Word
+    {
+        char text[12] = {};
+
+        bool operator==(const Word &other) const
+        {
+            return strcmp(text, other.text) == 0;
+        }
+    };
+
+    // Rendered words are kept until the buffer is needed for others, switching back to a word (or
+    // a RND digit that was already spoken) plays it instantly.
+    uint8_t _buffer[48000];
+    LRUPool<Word, 16> _cache;
+
+    // The utterance is rendered in the background, a chunk per block (SAMRender), and becomes
+    // playable when complete. The SAM library is global - one engine renders at a time.
+    static inline SAM *_renderer = nullptr;
+    Word _target = {};
+    int _target_len = 0;
+
+    // RND plays the current digit while the next one is rendered
+    Word _rnd = {};
+    Word _rnd_next = {};
 
-    void say(const char *text)
+    bool say(const Word &word)
     {
-        static tsample_spec<uint8_t> *_sample = nullptr;
-        _sample = &_sounds[selection];
+        if (_renderer != nullptr)
+            return false;
+
+        _renderer = this;
+        _target = word;
+        _target_len = 0;
+        _cache.reserve(word);
 
         SAM_write_buffer = [](int pos, char value)
         {
-            if (pos < (int)LEN_OF(_buffer))
+            // drops the oldest words in its way as the new one grows
+            if (_renderer->_cache.grow(pos + 1))
             {
-                _sample->len = pos + 1;
-                ((uint8_t *)_sample->data)[pos] = value;
+                _renderer->_target_len = std::max(_renderer->_target_len, pos + 1);
+                _renderer->_cache.pending()[pos] = value;
             }
         };
 
@@ -72,40 +104,100 @@ struct SAM : public SampleEngine
         SetThroat(128);
 
         char input[256] = {};
-        sprintf(input, "%s ", text);
+        sprintf(input, "%s ", word.text);
         for (int i = 0; input[i] != 0; i++)
             input[i] = toupper((int)input[i]);
 
         strncat(input, "[", 255);
         TextToPhonemes((unsigned char *)input);
         SetInput(input);
-        SAMMain();
+        SAMPrepare();
+        return true;
     }
 
-    int _lastSelection = 0;
+    void render()
+    {
+        if (_renderer != this)
+            return;
+
+        if (SAMRender(RENDER_CHUNK) && (size_t)_target_len < _cache.size)
+            return;
+
+        _cache.commit(_target_len);
+        _renderer = nullptr;
+    }
+
+    bool cached(const Word &word)
+    {
+        size_t len;
+        return _cache.find(word, &len) != nullptr;
+    }
+
+    void random_digit(Word &word)
+    {
+        sprintf(word.text, "%d", rand() % 10);
+    }
 
 public:
     SAM() : SampleEngine()
     {
         setup(&_sounds[0], 0, LEN_OF(_sounds));
-        say(_sounds[0].name);
+        _cache.init(_buffer, sizeof(_buffer));
+        random_digit(_rnd);
+        random_digit(_rnd_next);
+
+        // not on the audio path - the first word is rendered completely
+        Word word;
+        strcpy(word.text, _sounds[0].name);
+        if (say(word))
+        {
+            while (_renderer == this)
+                render();
+        }
+    }
+
+    ~SAM() override
+    {
+        if (_renderer == this)
+            _renderer = nullptr;
     }
 
     void process(const ControlFrame &frame, OutputFrame &of) override
     {
-        if (selection == LEN_OF(_sounds) - 1 && frame.trigger)
+        Word word;
+        if (selection == RND)
         {
-            char tmp[20];
-            sprintf(tmp, "%d", rand() % 10);
-            say(tmp);
+            if (frame.trigger && cached(_rnd_next))
+            {
+                _rnd = _rnd_next;
+                random_digit(_rnd_next);
+            }
+
+            word = _rnd;
         }
-        else if (_lastSelection != selection)
+        else
+            strcpy(word.text, _sounds[selection].name);
+
+        if (_renderer == this && !(_target == word) && !(selection == RND && _target == _rnd_next))
+            _renderer = nullptr; // selection changed, the pending word is dropped
+
+        if (_renderer == nullptr)
         {
-            say(_sounds[selection].name);
-            _lastSelection = selection;
+            if (!cached(word))
+                say(word);
+            else if (selection == RND && !cached(_rnd_next))
+                say(_rnd_next);
         }
 
-        SampleEngine::process(frame, of);
+        render();
+
+        // pointers into the cache are refreshed per block, a word may be dropped while another is rendered
+        size_t len = 0;
+        auto &sound = _sounds[selection];
+        sound.data = _cache.find(word, &len);
+        sound.len = sound.data ? len : 0;
+
+        SampleEngine::process(frame, of); // silence while the word is not ready (len == 0)
     }
 };
 
@@ -1,6 +1,7 @@
 #include "machine.h"
 #include "stmlib/dsp/dsp.h"
 #include "stmlib/dsp/units.h"
+#include "misc/pitch.hxx"
 
 struct dsp
 {
@@ -114,6 +115,11 @@ public:
         }
     }
 
+    static size_t memory_footprint()
+    {
+        return sizeof(FaustEngine) + sizeof(T);
+    }
+
     ~FaustEngine() override
     {
         machine::mfree(_faust);
@@ -124,7 +130,7 @@ public:
 
     float note_to_frequency(float note)
     {
-        return base_frequency * powf(2.f, (note - base_pitch) / 12.f);
+        return base_frequency * pitch::exp2((note - base_pitch) * (1.f / 12.f));
     }
 
     void process(const machine::ControlFrame &frame, OutputFrame &of) override
@@ -0,0 +1,257 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include "machine.h"
+#include "plaits/dsp/engine/engine.h"
+#include "plaits/dsp/envelope.h"
+#include "plaits/dsp/voice.h"
+#include "stmlib/algorithms/voice_allocator.h"
+#include "stmlib/utils/random.h"
+#include "base/SilenceDetector.hxx"
+
+// Polyphonic MIDI engine for any plaits::Engine: one engine instance per voice, a shared
+// BufferAllocator arena, stmlib::VoiceAllocator (voice stealing) and a LPG + post processing
+// per voice like plaits::Voice. Voices decayed below SilenceDetector::THRESHOLD are not rendered.
+//
+// Voice activity: rendered = the voices rendered in the last block (bench_voices measures the
+// time per rendered voice of each engine).
+class PolyPlaitsVoices : public machine::MidiEngine
+{
+public:
+    static constexpr size_t kMaxVoices = 16;
+
+    uint8_t rendered = 0;
+
+    // Limits the polyphony (e.g. to the number of voices that fit into a block)
+    void set_voices(size_t n)
+    {
+        num_voices = std::clamp<size_t>(n, 1, max_voices);
+        allocator.set_size(num_voices);
+    }
+
+    size_t voices() const
+    {
+        return num_voices;
+    }
+
+protected:
+    size_t max_voices;
+    size_t num_voices;
+
+    float harmonics, timbre, morph;
+    float pitch = 0;
+    float pitch_bend = 0;
+    float decay = 0.5f;
+    float stereo = 0.5f;
+    float hf = 0.5f;
+
+    // false: the voice output is only scaled by the LPG gain, no LPG filter and post processing (PolyVA)
+    bool lpg_filter = true;
+
+    plaits::EngineParameters parameters[kMaxVoices] = {};
+    plaits::LPGEnvelope lpg[kMaxVoices];
+    plaits::ChannelPostProcessor post[kMaxVoices];
+    float gainL[kMaxVoices];
+    float gainR[kMaxVoices];
+
+    stmlib::VoiceAllocator<kMaxVoices> allocator;
+
+    uint8_t *_buffer = nullptr;
+
+    float polyBuffL[machine::FRAME_BUFFER_SIZE];
+    float polyBuffR[machine::FRAME_BUFFER_SIZE];
+    float engineBuff[machine::FRAME_BUFFER_SIZE];
+    float voiceBuff[machine::FRAME_BUFFER_SIZE];
+    float dummy[machine::FRAME_BUFFER_SIZE];
+
+    virtual plaits::Engine *engine(size_t i) = 0;
+
+    PolyPlaitsVoices(size_t voices, size_t buffer_size) : max_voices(std::min(voices, kMaxVoices)), num_voices(max_voices)
+    {
+        allocator.Init();
+        allocator.set_size(num_voices);
+
+        _buffer = (uint8_t *)machine::malloc(buffer_size);
+
+        for (size_t i = 0; i < kMaxVoices; i++)
+        {
+            lpg[i].Init();
+            post[i].Init();
+        }
+    }
+
+    ~PolyPlaitsVoices() override
+    {
+        machine::mfree(_buffer);
+    }
+
+    void init_params(const char *h, float hh, const char *t, float tt, const char *m, float mm)
+    {
+        param[0].init_v_oct("Pitch", &pitch);
+        param[1].init(h, &harmonics, hh);
+        param[2].init(t, &timbre, tt);
+        param[3].init(m, &morph, mm);
+        param[4].init("Decay", &decay, decay);
+        param[5].init("Stereo", &stereo, stereo);
+    }
+
+public:
+    void process(const machine::ControlFrame &frame, machine::OutputFrame &of) override
+    {
+        using namespace machine;
+
+        std::fill_n(polyBuffL, FRAME_BUFFER_SIZE, 0);
+        std::fill_n(polyBuffR, FRAME_BUFFER_SIZE, 0);
+        rendered = 0;
+
+        if (_buffer == nullptr)
+            return;
+
+        const float short_decay = (200.0f * FRAME_BUFFER_SIZE) / SAMPLE_RATE *
+                                  stmlib::SemitonesToRatio(-96.0f * decay);
+
+        const float decay_tail = (20.0f * FRAME_BUFFER_SIZE) / SAMPLE_RATE *
+                                     stmlib::SemitonesToRatio(-72.0f * decay + 12.0f * hf) -
+                                 short_decay;
+
+        for (size_t i = 0; i < num_voices; i++)
+        {
+            lpg[i].ProcessPing(0.5f, short_decay, decay_tail, hf);
+
+            // decayed voices are not rendered until the next note on
+            if (lpg[i].gain() < SilenceDetector::THRESHOLD && parameters[i].trigger == plaits::TriggerState::TRIGGER_LOW)
+                continue;
+
+            auto p = parameters[i];
+            p.note += (pitch * 12.f) + pitch_bend;
+            p.timbre = timbre;
+            p.morph = morph;
+            p.harmonics = harmonics;
+
+            plaits::Engine *e = engine(i);
+            bool enveloped = e->post_processing_settings.already_enveloped;
+            for (size_t s = 0; s < FRAME_BUFFER_SIZE; s += plaits::kMaxBlockSize)
+                e->Render(p, &engineBuff[s], &dummy[s], std::min<size_t>(plaits::kMaxBlockSize, FRAME_BUFFER_SIZE - s), &enveloped);
+
+            float gain = 1.f;
+            if (lpg_filter)
+                post[i].Process(e->post_processing_settings.out_gain, enveloped, lpg[i].gain(), lpg[i].frequency(),
+                                lpg[i].hf_bleed(), engineBuff, voiceBuff, FRAME_BUFFER_SIZE, 1);
+            else
+                gain = lpg[i].gain();
+
+            const float *out = lpg_filter ? voiceBuff : engineBuff;
+            const float l = gain * gainL[i];
+            const float r = gain * gainR[i];
+
+            for (int s = 0; s < FRAME_BUFFER_SIZE; s++)
+            {
+                polyBuffL[s] += out[s] * l;
+                polyBuffR[s] += out[s] * r;
+            }
+
+            parameters[i].trigger = plaits::TriggerState::TRIGGER_LOW;
+            rendered++;
+        }
+
+        of.push(polyBuffL, FRAME_BUFFER_SIZE);
+        of.push(polyBuffR, FRAME_BUFFER_SIZE);
+    }
+
+    void onMidiNote(uint8_t key, uint8_t velocity) override // NoteOff: velocity == 0
+    {
+        if (velocity > 0)
+        {
+            auto ni = allocator.NoteOn(key);
+            parameters[ni].trigger = plaits::TriggerState::TRIGGER_RISING_EDGE;
+            parameters[ni].note = key;
+            parameters[ni].accent = velocity > 100;
+
+            float pan = 0.5f + stereo * (stmlib::Random::GetFloat() - 0.5f);
+            gainL[ni] = cosf(pan * M_PI / 2);
+            gainR[ni] = sinf(pan * M_PI / 2);
+
+            lpg[ni].Trigger();
+        }
+        else
+        {
+            allocator.NoteOff(key);
+        }
+    }
+
+    void onMidiPitchbend(int16_t pitch) override
+    {
+        pitch_bend = ((float)pitch / 8192) * 12;
+    }
+
+    void onMidiCC(uint8_t ccc, uint8_t value) override
+    {
+        // nothing implemented..
+    }
+
+    void display() override
+    {
+        gfx::drawEngine(this, _buffer ? nullptr : machine::OUT_OF_MEMORY);
+    }
+};
+
+// N voices of the plaits engine T, MEM floats of BufferAllocator memory per voice
+template <class T, size_t N, size_t MEM = 48>
+class PolyPlaitsEngine : public PolyPlaitsVoices
+{
+    T voice[N];
+
+    plaits::Engine *engine(size_t i) override
+    {
+        return &voice[i];
+    }
+
+public:
+    static size_t memory_footprint()
+    {
+        return sizeof(PolyPlaitsEngine) + N * MEM * sizeof(float);
+    }
+
+    PolyPlaitsEngine(const plaits::PostProcessingSettings &settings) : PolyPlaitsVoices(N, N * MEM * sizeof(float))
+    {
+        static_assert(N <= kMaxVoices, "");
+
+        if (_buffer == nullptr)
+            return;
+
+        stmlib::BufferAllocator allocator;
+        allocator.Init(_buffer, N * MEM * sizeof(float));
+
+        for (size_t i = 0; i < N; i++)
+        {
+            voice[i].Init(&allocator);
+            voice[i].LoadUserData(nullptr);
+            voice[i].Reset();
+            voice[i].post_processing_settings = settings;
+        }
+    }
+};
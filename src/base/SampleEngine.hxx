@@ -27,6 +27,7 @@
 #include "machine.h"
 #include "stmlib/dsp/dsp.h"
 #include "stmlib/dsp/units.h"
+#include "misc/pitch.hxx"
 
 struct SampleEngine : public machine::Engine
 {
@@ -45,10 +46,21 @@ struct SampleEngine : public machine::Engine
         const void *data;
         int addr_shift;
         virtual float get_float(int index) const = 0;
+
+        // Decodes count samples starting at index into out (one virtual call per run of samples)
+        virtual void read(int index, int count, float *out) const
+        {
+            for (int k = 0; k < count; k++)
+                out[k] = get_float(index + k);
+        }
     };
 
+    // Max. decoded samples per run (on stack), pitched up playback is split into shorter runs
+    static constexpr int READ_WINDOW = 64;
+
     const sample_spec *ptr = nullptr;
     float default_inc;
+    pitch::Cached<stmlib::SemitonesToRatio> pitch_ratio; // V/OCT changes rarely between blocks
     float inc;
 
     float buffer[machine::FRAME_BUFFER_SIZE];
@@ -79,6 +91,226 @@ struct SampleEngine : public machine::Engine
         return (((a * f) - b_neg) * f + c) * f + x0;
     }
 
+    // x points to the decoded sample at index_integral
+    static inline float InterpolateHermite(const float *x, float index_fractional)
+    {
+        const float xm1 = x[-1];
+        const float x0 = x[0];
+        const float x1 = x[1];
+        const float x2 = x[2];
+        const float c = (x1 - xm1) * 0.5f;
+        const float v = x0 - x1;
+        const float w = c + v;
+        const float a = w + v + (x2 - x0) * 0.5f;
+        const float b_neg = w + a;
+        const float f = index_fractional;
+        return (((a * f) - b_neg) * f + c) * f + x0;
+    }
+
+    // Renders size samples from position i (0..1, advanced by step per sample), silence outside [s, e)
+    static void render(const sample_spec &smpl, float &i, float step, float s, float e, float *p, int size)
+    {
+        // samples per run, so that the run (+ interpolation margin) fits into the window
+        const float span = fabsf(step) * smpl.len;
+        const int max_run = (span * size + 7) <= READ_WINDOW ? size : std::max(1, (int)((READ_WINDOW - 7) / span));
+
+        float window[READ_WINDOW];
+
+        while (size > 0)
+        {
+            const int n = std::min(size, max_run);
+            size -= n;
+
+            const float last = i + step * (n - 1);
+            const float lo = std::min(i, last);
+            const float hi = std::max(i, last);
+
+            if (hi < s || lo >= e)
+            {
+                for (int k = 0; k < n; k++)
+                {
+                    *p++ = 0;
+                    i += step;
+                }
+                continue;
+            }
+
+            const int first = (int)(lo * smpl.len) - 2;
+            const int count = std::min(READ_WINDOW, (int)(hi * smpl.len) + 5 - first);
+            smpl.read(first, count, window);
+
+            for (int k = 0; k < n; k++)
+            {
+                if (s <= i && i < e)
+                {
+                    float index = i * smpl.len;
+                    MAKE_INTEGRAL_FRACTIONAL(index)
+                    *p++ = InterpolateHermite(&window[index_integral - first], index_fractional);
+                }
+                else
+                {
+                    *p++ = 0;
+                }
+                i += step;
+            }
+        }
+    }
+
+    // Polyphonic playback: every trigger starts a voice with the sample, pitch and start/end
+    // of that moment. A new trigger steals the quietest (then oldest) voice if none is free.
+    // Voices are not cut off: a stolen voice and the voices beyond "Voices" fade out (1ms).
+    struct Voice
+    {
+        uint8_t sample = 0;
+        float i = 0;
+        float step = 0;
+        float s = 0;
+        float e = 0;
+        float level = 0; // peak of the last block
+        uint32_t age = 0;
+        float gain = 1; // < 1 fading out, stopped at 0
+
+        inline bool active() const
+        {
+            return step > 0 ? (i < e) : (step < 0 && i >= s);
+        }
+    };
+
+    static constexpr int MAX_VOICES = 16;
+    Voice voices[MAX_VOICES];
+    uint8_t num_voices = 1;
+    uint8_t last_num_voices = 1;
+    uint32_t voice_count = 0;
+
+    // One trigger per block: stolen voices of the last FADE_SAMPLES overlap, none is cut off
+    static constexpr int FADE_SAMPLES = machine::SAMPLE_RATE / 1000;
+    static constexpr float FADE_OUT = 1.f / FADE_SAMPLES;
+    static constexpr int FADE_VOICES = FADE_SAMPLES / machine::FRAME_BUFFER_SIZE + 1;
+    Voice stolen[FADE_VOICES];
+    bool fading = false;
+
+    // Renders v with its fade out gain into out, false when the voice is done
+    bool fade_out(Voice &v, float *out)
+    {
+        float tmp[machine::FRAME_BUFFER_SIZE];
+        render(ptr[v.sample], v.i, v.step, v.s, v.e, tmp, machine::FRAME_BUFFER_SIZE);
+
+        for (int j = 0; j < machine::FRAME_BUFFER_SIZE; j++)
+        {
+            v.gain -= FADE_OUT;
+            if (v.gain <= 0)
+            {
+                v.step = 0;
+                return false;
+            }
+            out[j] += tmp[j] * v.gain;
+        }
+        return v.active();
+    }
+
+    // Adds the fading voices to out: the stolen ones and those beyond the voice count (all in mono mode)
+    void fade_out_voices(float *out)
+    {
+        if (num_voices != last_num_voices)
+        {
+            last_num_voices = num_voices;
+            fading = true;
+        }
+
+        if (!fading)
+            return;
+
+        fading = false;
+
+        for (auto &v : stolen)
+            if (v.active())
+                fading |= fade_out(v, out);
+
+        for (int k = 0; k < MAX_VOICES; k++)
+        {
+            Voice &v = voices[k];
+            if (!v.active() || (k < num_voices && num_voices > 1 && v.gain >= 1))
+                continue;
+
+            fading |= fade_out(v, out);
+        }
+    }
+
+    // Takes over a voice that is stolen, replaces the one closest to the end of its fade if all are busy
+    void steal(const Voice &v)
+    {
+        Voice *slot = &stolen[0];
+        for (auto &f : stolen)
+        {
+            if (!f.active())
+            {
+                slot = &f;
+                break;
+            }
+
+            if (f.gain < slot->gain)
+                slot = &f;
+        }
+
+        *slot = v;
+        fading = true;
+    }
+
+    Voice &allocate_voice()
+    {
+        Voice *v = &voices[0];
+        for (int k = 0; k < num_voices; k++)
+        {
+            if (!voices[k].active())
+                return voices[k];
+
+            if (voices[k].level < v->level || (voices[k].level == v->level && voices[k].age < v->age))
+                v = &voices[k];
+        }
+        return *v;
+    }
+
+    void process_voices(const machine::ControlFrame &frame, float s, float e, float step)
+    {
+        if (frame.trigger)
+        {
+            Voice &v = allocate_voice();
+            if (v.active())
+                steal(v);
+
+            v.sample = selection;
+            v.i = start;
+            v.step = step;
+            v.s = s;
+            v.e = e;
+            v.level = 1;
+            v.age = ++voice_count;
+            v.gain = 1;
+        }
+
+        float tmp[machine::FRAME_BUFFER_SIZE];
+        std::fill_n(buffer, machine::FRAME_BUFFER_SIZE, 0);
+
+        for (int k = 0; k < num_voices; k++)
+        {
+            Voice &v = voices[k];
+            if (!v.active() || v.gain < 1)
+                continue;
+
+            render(ptr[v.sample], v.i, v.step, v.s, v.e, tmp, machine::FRAME_BUFFER_SIZE);
+
+            float peak = 0;
+            for (int j = 0; j < machine::FRAME_BUFFER_SIZE; j++)
+            {
+                buffer[j] += tmp[j];
+                peak = std::max(peak, fabsf(tmp[j]));
+            }
+            v.level = peak;
+        }
+
+        fade_out_voices(buffer);
+    }
+
 public:
     int loop = 0; // 1 = knight rider, 2 infinite
 
@@ -108,20 +340,36 @@ public:
         // };
     }
 
+    // Opt-in for polyphonic playback (param[4]), 1 voice = retrigger restarts the sample
+    void setup_voices(int count)
+    {
+        param[4].init("Voices", &num_voices, count, 1, MAX_VOICES);
+        last_num_voices = num_voices;
+    }
+
     void process(const machine::ControlFrame &frame, machine::OutputFrame &of) override
     {
         auto &smpl = ptr[selection];
 
+        if (smpl.len == 0) // no sample (yet), e.g. SAM while the word renders
+        {
+            if (frame.trigger)
+                i = start;
+
+            std::fill_n(buffer, machine::FRAME_BUFFER_SIZE, 0);
+            of.out = buffer;
+            return;
+        }
+
         this->default_inc = 1.0f / smpl.len * (smpl.sample_rate / (float)machine::SAMPLE_RATE);
 
-        this->default_inc *= stmlib::SemitonesToRatio(frame.qz_voltage(this->io, 0.f) * 12);
+        this->default_inc *= pitch_ratio(frame.qz_voltage(this->io, 0.f) * 12);
 
         float pitch_fine = 0;
         this->inc = (this->inc < 0 ? -1.f : 1.f) *
                     (default_inc + (default_inc * pitch_fine * 0.5f) + (default_inc * pitch_coarse * 2.f));
 
-        auto p = buffer;
-        auto size = machine::FRAME_BUFFER_SIZE;
+        int size = machine::FRAME_BUFFER_SIZE;
 
         if (frame.trigger)
         {
@@ -142,15 +390,19 @@ public:
         //     i = start;
         // }
 
-        float s = std::min(start, end);
-        float e = std::max(start, end);
+        const float s = std::min(start, end);
+        const float e = std::max(start, end);
+        const float step = this->start < this->end ? inc : -inc;
 
-        while (size--)
+        if (num_voices > 1)
         {
-            *p++ = s <= i && i < e ? InterpolateHermite(smpl, i) : 0;
-            i += this->start < this->end ? inc : -inc;
+            process_voices(frame, s, e, step);
+            of.out = buffer;
+            return;
         }
 
+        render(smpl, i, step, s, e, buffer, size);
+
         if (loop == 0)
         {
 
@@ -168,6 +420,8 @@ public:
                 i -= (e-s);
         }
 
+        fade_out_voices(buffer); // voices of the polyphonic mode before "Voices" was set to 1
+
         of.out = buffer;
     }
 };
@@ -177,6 +431,12 @@ struct tsample_spec : SampleEngine::sample_spec
 {
     virtual float get_float(int index) const;
 
+    void read(int index, int count, float *out) const override
+    {
+        for (int k = 0; k < count; k++)
+            out[k] = tsample_spec<T>::get_float(index + k); // no virtual dispatch
+    }
+
     tsample_spec(const char *name, const T *data, size_t len, uint16_t sample_rate, int custom)
     {
         this->data = data;
@@ -196,7 +456,7 @@ struct Am6070sample : tsample_spec<uint8_t>
     // for (int i = 0; i < 128; i++)
     //     antilog[i] = (int16_t)((2 * powf(2.0, i >> 4) * ((i & 15) + 16.5) - 16.5));
 
-    float get_float(int index) const override
+    static inline float decode(uint8_t ix, int gain)
     {
         static const int16_t antilog[128] = {
             0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
@@ -208,15 +468,24 @@ struct Am6070sample : tsample_spec<uint8_t>
             2079, 2207, 2335, 2463, 2591, 2719, 2847, 2975, 3103, 3231, 3359, 3487, 3615, 3743, 3871, 3999,
             4191, 4447, 4703, 4959, 5215, 5471, 5727, 5903, 6239, 6495, 6751, 7007, 7263, 7519, 7775, 8031};
 
+        return (float)((ix & 0x80) ? -antilog[ix & 0x7F] : antilog[ix]) / INT16_MAX * gain;
+    }
+
+    float get_float(int index) const override
+    {
         if (index < this->len)
-        {
-            auto ix = reinterpret_cast<const uint8_t *>(this->data)[index];
-            return (float)((ix & 0x80) ? -antilog[ix & 0x7F] : antilog[ix]) / INT16_MAX * this->addr_shift;
-        }
+            return decode(reinterpret_cast<const uint8_t *>(this->data)[index], this->addr_shift);
         else
             return 0;
     }
 
+    void read(int index, int count, float *out) const override
+    {
+        auto data = reinterpret_cast<const uint8_t *>(this->data);
+        for (int k = 0; k < count; k++, index++)
+            out[k] = (index >= 0 && index < this->len) ? decode(data[index], this->addr_shift) : 0;
+    }
+
     Am6070sample(const char *name, const uint8_t *data, size_t len, uint16_t sample_rate, int custom)
         : tsample_spec<uint8_t>(name, data, len, sample_rate, custom)
     {
@@ -0,0 +1,77 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include "machine.h"
+#include <math.h>
+
+// Opt-in for engines that can skip their DSP once the output has decayed:
+// track() every rendered block, silent() gets true after 50ms below -96dBFS.
+// The engine has to reset() on trigger/gate and render silence while silent().
+struct SilenceDetector
+{
+    static constexpr float THRESHOLD = 1.6e-5f; // -96dBFS
+    static constexpr uint32_t HOLD_BLOCKS = machine::SAMPLE_RATE / machine::FRAME_BUFFER_SIZE / 20;
+
+    uint32_t quiet_blocks = 0;
+
+    inline void reset()
+    {
+        quiet_blocks = 0;
+    }
+
+    inline bool silent() const
+    {
+        return quiet_blocks >= HOLD_BLOCKS;
+    }
+
+    inline void track(const float *buffer, size_t len)
+    {
+        float peak = 0;
+        for (size_t i = 0; i < len; i++)
+            peak = std::max(peak, fabsf(buffer[i]));
+
+        update(peak < THRESHOLD);
+    }
+
+    inline void track(const int16_t *buffer, size_t len)
+    {
+        int32_t peak = 0;
+        for (size_t i = 0; i < len; i++)
+            peak = std::max(peak, abs((int32_t)buffer[i]));
+
+        update(peak <= 1);
+    }
+
+private:
+    inline void update(bool quiet)
+    {
+        if (!quiet)
+            quiet_blocks = 0;
+        else if (quiet_blocks < HOLD_BLOCKS)
+            quiet_blocks++;
+    }
+};
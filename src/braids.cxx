@@ -105,7 +105,8 @@ struct BraidsEngine : public Engine
 
         osc1.set_parameters(_timbre >> 1, _color >> 1);
         osc1.set_pitch(pitch + settings.pitch_transposition());
-        osc1.Render(sync_samples, audio_samples, FRAME_BUFFER_SIZE);
+        for (size_t i = 0; i < FRAME_BUFFER_SIZE; i += braids::kMaxBlockSize)
+            osc1.Render(&sync_samples[i], &audio_samples[i], std::min<size_t>(braids::kMaxBlockSize, FRAME_BUFFER_SIZE - i));
 
         for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
             audio_samples[i] = (gain * audio_samples[i]) / UINT16_MAX;
@@ -126,7 +127,8 @@ struct BraidsEngine : public Engine
 
             osc2.set_parameters((timbre >> 1), (color >> 1));
             osc2.set_pitch(pitch + settings.pitch_transposition() + stereo);
-            osc2.Render(sync_samples, audio_samples, FRAME_BUFFER_SIZE);
+            for (size_t i = 0; i < FRAME_BUFFER_SIZE; i += braids::kMaxBlockSize)
+                osc2.Render(&sync_samples[i], &audio_samples[i], std::min<size_t>(braids::kMaxBlockSize, FRAME_BUFFER_SIZE - i));
 
             for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
                 audio_samples[i] = (gain * audio_samples[i]) / UINT16_MAX;
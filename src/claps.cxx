@@ -27,6 +27,7 @@
 #include "drumsynth/drumsynth.h"
 #include "drumsynth/drumsynth_claps.h"
 #include "misc/noise.hxx"
+#include "base/SilenceDetector.hxx"
 
 using namespace machine;
 
@@ -37,6 +38,7 @@ private:
     float tmp2[FRAME_BUFFER_SIZE];
     float buffer[FRAME_BUFFER_SIZE];
     float bufferAux[FRAME_BUFFER_SIZE];
+    SilenceDetector _silence;
     static constexpr size_t n = 8;
 
     DrumSynth _instA = nullptr;
@@ -64,14 +66,12 @@ private:
         {0x082087A1, 1.3f},
     };
 
-public:
-    ClapsEngine(const uint8_t *packed_drumKit) : Engine(TRIGGER_INPUT),
-                                                 inst_count(packed_drumKit[0])
+    // Instruments of a packed kit (used by the constructor and memory_footprint), returns the count
+    static size_t unpack(const uint8_t *packed_drumKit, DrumModel *inst)
     {
-        // unpack
         const uint8_t *p = packed_drumKit;
         p+=4;
-        for (size_t i = 0; i < inst_count; i++)
+        for (size_t i = 0; i < packed_drumKit[0]; i++)
         {
             inst[i].name = reinterpret_cast<const char *>(p);
             p += 12;
@@ -81,6 +81,15 @@ public:
             p += inst[i].n * sizeof(PartArgs);
         }
 
+        return packed_drumKit[0];
+    }
+
+public:
+    ClapsEngine(const uint8_t *packed_drumKit) : Engine(TRIGGER_INPUT),
+                                                 inst_count(packed_drumKit[0])
+    {
+        unpack(packed_drumKit, inst);
+
         param[0].init("Color", &pitch, pitch, 0.5f, 1.5f);
         param[1].init_presets("Clap", &inst_selection, 0, 0, inst_count + LEN_OF(seeds) - 1);
         param[1].value_changed = [&]()
@@ -111,6 +120,17 @@ public:
         load_instrument(inst_selection);
     }
 
+    // Largest instrument of the kit: its (random) part args + two drum synths
+    static size_t memory_footprint(const uint8_t *packed_drumKit)
+    {
+        DrumModel kit[LEN_OF(inst)];
+        size_t max_n = 0;
+        for (size_t i = 0, count = unpack(packed_drumKit, kit); i < count; i++)
+            max_n = std::max<size_t>(max_n, kit[i].n);
+
+        return sizeof(ClapsEngine) + max_n * sizeof(PartArgs) + 2 * drum_synth_size(max_n);
+    }
+
     ~ClapsEngine() override
     {
         free_instrument();
@@ -146,7 +166,10 @@ public:
                     a = it.second;
 
             auto partArgs = (PartArgs *)machine::malloc(_cur_inst.n * sizeof(PartArgs));
-            for (size_t i = 0; i < _cur_inst.n; i++)
+            if (partArgs == nullptr)
+                _cur_inst = inst[0];
+
+            for (size_t i = 0; partArgs && i < _cur_inst.n; i++)
             {
                 size_t n = inst_count;
                 DrumModel in = inst[r.next() % n];
@@ -173,7 +196,8 @@ public:
                 partArgs[i].level *= a;
             }
 
-            _cur_inst.part = partArgs;
+            if (partArgs)
+                _cur_inst.part = partArgs;
         }
 
         machine::mfree(_instA);
@@ -195,6 +219,7 @@ public:
                 load_instrument(inst_selection);
 
             t = 0;
+            _silence.reset();
 
             drum_synth_reset(_instA);
             drum_synth_reset(_instB);
@@ -246,6 +271,11 @@ public:
             }
 
             t += machine::FRAME_BUFFER_SIZE;
+
+            // stop rendering once the instrument has decayed
+            _silence.track(buffer, LEN_OF(buffer));
+            if (_silence.silent())
+                t = UINT32_MAX;
         }
 
         of.out = buffer;
@@ -33,11 +33,19 @@
 
 #include <unistd.h>
 #include <limits.h>
+#include <numeric>
 
 #include "plaits/resources.h"
 
 using namespace machine;
 
+// msfa renders blocks of N samples, the engine reads FRAME_BUFFER_SIZE - the ring buffer must be
+// a multiple of both (no wrap inside a read/write) and hold max(N, FRAME_BUFFER_SIZE) + N - 1 samples
+constexpr size_t dx_buffer_size(size_t lcm)
+{
+    return lcm > std::max<size_t>(N, FRAME_BUFFER_SIZE) + N - 1 ? lcm : dx_buffer_size(lcm + std::lcm<size_t>(N, FRAME_BUFFER_SIZE));
+}
+
 struct DxFMEngine : public MidiEngine
 {
     struct dxfm
@@ -47,7 +55,7 @@ struct DxFMEngine : public MidiEngine
         Lfo lfo;
         FmCore fm_core;
         Dx7Note dx7_note;
-        stmlib::RingBuffer<int32_t, N * 3> buffer;
+        stmlib::RingBuffer<int32_t, dx_buffer_size(std::lcm<size_t>(N, FRAME_BUFFER_SIZE))> buffer;
     } voices[2];
     Controllers controllers;
 
@@ -56,22 +64,11 @@ struct DxFMEngine : public MidiEngine
     float _hold;
     float _rate;
 
-    char patch[128] = {// MARIMBA
-                       0x00, 0x3f, 0x37, 0x00, 0x4e, 0x4e, 0x00, 0x00, 0x29, 0x00, 0x00, 0x00,
-                       0x38, 0x08, 0x63, 0x08, 0x0d, 0x63, 0x4b, 0x00, 0x08, 0x52, 0x30, 0x00,
-                       0x00, 0x36, 0x00, 0x2e, 0x00, 0x38, 0x08, 0x5d, 0x00, 0x32, 0x63, 0x4b,
-                       0x00, 0x52, 0x52, 0x30, 0x00, 0x00, 0x36, 0x00, 0x2e, 0x00, 0x38, 0x08,
-                       0x55, 0x0a, 0x00, 0x5f, 0x21, 0x31, 0x29, 0x63, 0x5c, 0x00, 0x00, 0x00,
-                       0x00, 0x00, 0x00, 0x3b, 0x04, 0x63, 0x00, 0x00, 0x63, 0x48, 0x00, 0x00,
-                       0x52, 0x30, 0x00, 0x00, 0x36, 0x00, 0x2e, 0x00, 0x38, 0x08, 0x60, 0x06,
-                       0x00, 0x5f, 0x28, 0x31, 0x37, 0x63, 0x5c, 0x00, 0x00, 0x00, 0x00, 0x00,
-                       0x00, 0x3b, 0x00, 0x5f, 0x00, 0x00, 0x5e, 0x43, 0x5f, 0x3c, 0x32, 0x32,
-                       0x32, 0x32, 0x06, 0x08, 0x23, 0x00, 0x00, 0x00, 0x31, 0x18, 0x4d, 0x41,
-                       0x52, 0x49, 0x4d, 0x42, 0x41, 0x20, 0x20, 0x20};
-
     uint8_t data[156];
     char patch_name[12];
 
+    uint8_t _env_rate[6][4]; // envelope rates of the patch, before applyRate
+
 #define OP_ENV_RATE(op, i) data[op * 21 + i]
 #define OP_ENV_LEVEL(op, i) data[op * 21 + 4 + i]
 #define OP_kbd_lev_scl_brk_pt(op) data[op * 21 + 8]
@@ -122,10 +119,9 @@ struct DxFMEngine : public MidiEngine
     {
         for (int op = 0; op < 6; op++)
         {
-            auto opData = &patch[op * 17];
             for (int j = 1; j < 4; j++)
             {
-                auto v = min(opData[j] & 0x7f, 99);
+                auto v = min(_env_rate[op][j] & 0x7f, 99);
                 OP_ENV_RATE(op, j) = min((int)(v * -rate), 99);
             }
 
@@ -172,13 +168,36 @@ struct DxFMEngine : public MidiEngine
         };
         param[3].init("Hold", &_hold, 0, 0, SAMPLE_RATE / FRAME_BUFFER_SIZE);
 
+        static const char patch[128] = {// MARIMBA
+                                        0x00, 0x3f, 0x37, 0x00, 0x4e, 0x4e, 0x00, 0x00, 0x29, 0x00, 0x00, 0x00,
+                                        0x38, 0x08, 0x63, 0x08, 0x0d, 0x63, 0x4b, 0x00, 0x08, 0x52, 0x30, 0x00,
+                                        0x00, 0x36, 0x00, 0x2e, 0x00, 0x38, 0x08, 0x5d, 0x00, 0x32, 0x63, 0x4b,
+                                        0x00, 0x52, 0x52, 0x30, 0x00, 0x00, 0x36, 0x00, 0x2e, 0x00, 0x38, 0x08,
+                                        0x55, 0x0a, 0x00, 0x5f, 0x21, 0x31, 0x29, 0x63, 0x5c, 0x00, 0x00, 0x00,
+                                        0x00, 0x00, 0x00, 0x3b, 0x04, 0x63, 0x00, 0x00, 0x63, 0x48, 0x00, 0x00,
+                                        0x52, 0x30, 0x00, 0x00, 0x36, 0x00, 0x2e, 0x00, 0x38, 0x08, 0x60, 0x06,
+                                        0x00, 0x5f, 0x28, 0x31, 0x37, 0x63, 0x5c, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                        0x00, 0x3b, 0x00, 0x5f, 0x00, 0x00, 0x5e, 0x43, 0x5f, 0x3c, 0x32, 0x32,
+                                        0x32, 0x32, 0x06, 0x08, 0x23, 0x00, 0x00, 0x00, 0x31, 0x18, 0x4d, 0x41,
+                                        0x52, 0x49, 0x4d, 0x42, 0x41, 0x20, 0x20, 0x20};
+
         UnpackPatch(patch, (char *)data);
+        initRates();
         loadDXPatch((_bnkNum < 0) ? 1 : 0); // If patch available, select first
     }
 
     const int _bnkNum = -1;
     const char DXFM_PATCH[8] = {'D', 'X', 'F', 'M', 'S', 'Y', 'X', '0'};
 
+    void initRates()
+    {
+        for (int op = 0; op < 6; op++)
+            for (int j = 0; j < 4; j++)
+                _env_rate[op][j] = OP_ENV_RATE(op, j);
+
+        applyRate(_rate);
+    }
+
     void loadDXPatch(uint8_t prog)
     {
         const uint8_t *sysexData = nullptr;
@@ -203,8 +222,8 @@ struct DxFMEngine : public MidiEngine
                 if (_bnkNum < 0)
                     sysexData -= 128;
 
-                memcpy(patch, (const char *)sysexData + (prog * 128), sizeof(patch));
-                UnpackPatch(patch, (char *)data);
+                UnpackPatch((const char *)sysexData + (prog * 128), (char *)data);
+                initRates();
                 sprintf(patch_name, "%.10s", NAME());
                 loadPatch = false;
                 _prog = prog;
@@ -318,7 +337,7 @@ struct DxFMEngine : public MidiEngine
                     --voice.key_down;
         }
 
-        if (voices[0].buffer.readable() < N)
+        while (voices[0].buffer.readable() < std::max<size_t>(N, FRAME_BUFFER_SIZE))
         {
             // see midinote_to_logfreq
             float note = frame.qz_voltage(this->io, 2.f + _pitch) * 12.f + machine::DEFAULT_NOTE;
@@ -26,7 +26,7 @@
 #include "stmlib/stmlib.h"
 #include "stmlib/dsp/units.h"
 #include "stmlib/dsp/filter.h"
-#include "stmlib/dsp/delay_line.h"
+#include "misc/delay_line.hxx"
 #include "machine.h"
 #include <vector>
 
@@ -36,6 +36,8 @@
 
 using namespace machine;
 
+// Line = DelayLine16 (default) or DelayLine12 (longer delays in the same memory), max_time_ms <= line length
+template <class Line, int max_time_ms>
 struct Delay : public Engine
 {
     float time = 0.5f;
@@ -43,39 +45,34 @@ struct Delay : public Engine
     float level = 0.5f;
     float pan = 0.5f;
 
-    constexpr static int delay_len = 48000; // 1s
+    constexpr static int delay_len = Line::LENGTH;
+    constexpr static float max_time = max_time_ms / 1000.f;
 
-    stmlib::DelayLine<uint16_t, delay_len> *delay_mem[2];
+    Line *delay_mem[2];
     stmlib::OnePole filterLP[2];
     stmlib::OnePole filterHP[2];
 
-    inline const float DelayRead(stmlib::DelayLine<uint16_t, delay_len> *line_, float delay) const
-    {
-        return static_cast<float>(static_cast<int16_t>(line_->Read(delay))) / 32768.0f;
-    }
-
-    inline void DelayWrite(stmlib::DelayLine<uint16_t, delay_len> *line_, const float sample)
-    {
-        line_->Write(static_cast<uint16_t>(
-            stmlib::Clip16(static_cast<int32_t>(sample * 32768.0f))));
-    }
-
     float bufferL[FRAME_BUFFER_SIZE];
     float bufferR[FRAME_BUFFER_SIZE];
 
     Delay() : Engine(AUDIO_PROCESSOR)
     {
-        if (delay_mem[0] = (stmlib::DelayLine<uint16_t, delay_len> *)machine::malloc(sizeof(stmlib::DelayLine<uint16_t, delay_len>)))
+        if (delay_mem[0] = (Line *)machine::malloc(sizeof(Line)))
             delay_mem[0]->Init();
-        if (delay_mem[1] = (stmlib::DelayLine<uint16_t, delay_len> *)machine::malloc(sizeof(stmlib::DelayLine<uint16_t, delay_len>)))
+        if (delay_mem[1] = (Line *)machine::malloc(sizeof(Line)))
             delay_mem[1]->Init();
 
-        param[0].init("Time", &time, time);
+        param[0].init("Time", &time, time, 0, max_time);
         param[1].init("Color", &color, color);
         param[2].init("Pan", &pan, pan);
         param[3].init("Feedb", &level, level);
     }
 
+    static size_t memory_footprint()
+    {
+        return sizeof(Delay) + 2 * sizeof(Line);
+    }
+
     ~Delay() override
     {
         machine::mfree(delay_mem[0]);
@@ -110,19 +107,19 @@ struct Delay : public Engine
         sync_params();
 
         int n = 1 + time / t_32;
-        float d = n * t_32 * machine::SAMPLE_RATE;
+        float d = std::min<float>(n * t_32 * machine::SAMPLE_RATE, delay_len - 4);
 
         if (fabsf(d - delay) > machine::SAMPLE_RATE / 10)
             delay = d;
-        else
-            ONE_POLE(delay, d, 0.01f);
 
         float *ins[] = {machine::get_aux(AUX_L), machine::get_aux(AUX_R)};
 
         for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
         {
-            float readL = DelayRead(delay_mem[0], (int)delay);
-            float readR = DelayRead(delay_mem[1], (int)delay);
+            ONE_POLE(delay, d, 0.01f / FRAME_BUFFER_SIZE);
+
+            float readL = delay_mem[0]->ReadHermite(delay);
+            float readR = delay_mem[1]->ReadHermite(delay);
 
             auto inL = ins[0][i];
             auto inR = ins[1][i];
@@ -132,8 +129,8 @@ struct Delay : public Engine
             inR = filterLP[1].Process<stmlib::FILTER_MODE_LOW_PASS>(inR);
             inR = filterHP[1].Process<stmlib::FILTER_MODE_HIGH_PASS>(inR);
 
-            DelayWrite(delay_mem[0], (readR + inL * (0 + pan) * 2) * level);
-            DelayWrite(delay_mem[1], (readL + inR * (1 - pan) * 2) * level);
+            delay_mem[0]->Write((readR + inL * (0 + pan) * 2) * level);
+            delay_mem[1]->Write((readL + inR * (1 - pan) * 2) * level);
 
             bufferL[i] = readL + ins[0][i];
             bufferR[i] = readR + ins[1][i];
@@ -143,11 +140,18 @@ struct Delay : public Engine
         of.aux = bufferR;
     }
 
+    float last_color = -1;
+
     void sync_params()
     {
         calc_t_step32();
         param[0].step.f = param[0].step2.f = t_32;
 
+        if (color == last_color)
+            return;
+
+        last_color = color;
+
         float colorFreq = std::pow(100.f, 2.f * color - 1.f);
         float lowpassFreq = clamp(20000.f * colorFreq, 20.f, 20000.f) / machine::SAMPLE_RATE;
         float highpassFreq = clamp(20.f * colorFreq, 20.f, 20000.f) / machine::SAMPLE_RATE;
@@ -188,7 +192,8 @@ struct Delay : public Engine
 
 void init_delay()
 {
-    machine::add<Delay>(FX, "Delay");
+    machine::add<Delay<DelayLine16<48000>, 1000>>(FX, "Delay");
+    machine::add<Delay<DelayLine12<64000>, 1250>>(FX, "Delay-Long"); // 12-bit
 }
 
 MACHINE_INIT(init_delay);
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "machine.h"
+#include "misc/lru_cache.hxx"
 #include <stdio.h>
+#include <atomic>
 
 #include "fv1/FV1.h"
 
@@ -99,6 +101,43 @@ struct FV1_ROM
 
 static_assert(sizeof(FV1_ROM) == 128 + 512, "");
 
+// Indexed FV1_BNK0 (lib/fv1/fv1_bank.py): header + index with the names, every FV1_ROM compressed
+// separately -> engines are listed without decompression and any program decodes in constant time.
+// The legacy bank (u8 count, u16 size, one LZMA2 stream with all FV1_ROMs) is decoded sequentially.
+struct FV1_BANK_HEADER
+{
+    char magic[4]; // "FV1I"
+    uint8_t count;
+    uint8_t reserved[3];
+};
+
+struct FV1_BANK_ITEM
+{
+    uint32_t offset; // compressed FV1_ROM, relative to the bank
+    uint16_t size;
+    uint8_t props;
+    uint8_t reserved;
+    char name[32];
+    char pot0[16];
+    char pot1[16];
+    char pot2[16];
+};
+
+static_assert(sizeof(FV1_BANK_HEADER) == 8 && sizeof(FV1_BANK_ITEM) == 88, "");
+
+static const FV1_BANK_ITEM *fv1_bank_index(const uint8_t *bank)
+{
+    if (memcmp(bank, "FV1I", 4) == 0)
+        return (const FV1_BANK_ITEM *)&bank[sizeof(FV1_BANK_HEADER)];
+
+    return nullptr;
+}
+
+static int fv1_bank_count(const uint8_t *bank)
+{
+    return fv1_bank_index(bank) ? ((const FV1_BANK_HEADER *)bank)->count : bank[0];
+}
+
 struct FV1_Engine : public Engine
 {
     float inputGain = 1.f;
@@ -118,6 +157,22 @@ struct FV1_Engine : public Engine
     const uint8_t *xzrom = nullptr;
     void *ram = nullptr;
 
+    // FV1 is opaque (FV1.S), these are upper bounds: fv1_init() state incl. 32K words delay ram,
+    // fv1_load() decoded program and the xz decoder while a bank program is decoded.
+    static constexpr size_t FV1_HEAP = (32768 + 128) * sizeof(int32_t);
+    static constexpr size_t FV1_PROG_HEAP = 4096;
+    static constexpr size_t XZ_HEAP = 32 * 1024;
+
+    static size_t memory_footprint(const FV1_ARGS &args)
+    {
+        return sizeof(FV1_Engine) + FV1_HEAP;
+    }
+
+    static size_t memory_footprint(const FV1_BANK_ENTRY *bnk_entry)
+    {
+        return sizeof(FV1_Engine) + FV1_HEAP + FV1_PROG_HEAP + XZ_HEAP;
+    }
+
     FV1_Engine(const FV1_ARGS &args) : Engine(AUDIO_PROCESSOR)
     {
         fv1 = fv1_init(machine::malloc);
@@ -146,43 +201,84 @@ struct FV1_Engine : public Engine
         pot2 = 0.5f;
         raw = 1.f;
 
-        decode_rom(bnk_entry->index);
+        program = bnk_entry->index;
+        load_program();
+        fade = FADE_BLOCKS;
+        state = RUNNING;
     }
 
     char paramNames[4][16] = {};
 
-    void decode_rom(int index = -1)
+    // Program changes of the FV1emu bank: xz decoding and fv1_load run in the UI loop (display) - the
+    // audio path fades the wet signal out, plays dry until the program is loaded and fades in again.
+    // (there is not enough RAM for a second FV1 instance to crossfade both programs)
+    // display() is only called for the slot on screen: after LOAD_TIMEOUT the audio path loads the
+    // program itself (one FV1_ROM decode with the indexed bank, or none if it was prefetched).
+    enum : uint8_t
     {
-        machine::mfree(this->ram);
-        machine::mfree(this->fv1);
+        RUNNING,
+        PREFETCH, // RUNNING, the UI loop decodes a neighbour program into roms
+        FADE_OUT,
+        LOAD,
+        LOADING,
+        FADE_IN,
+    };
+
+    static constexpr int FADE_BLOCKS = machine::SAMPLE_RATE / 100 / machine::FRAME_BUFFER_SIZE;   // 10ms
+    static constexpr int LOAD_TIMEOUT = machine::SAMPLE_RATE / 10 / machine::FRAME_BUFFER_SIZE;  // 100ms
+
+    LRUCache<uint8_t, FV1_ROM, 3> roms; // current, next and previous program
+    std::atomic<uint8_t> state = RUNNING; // PREFETCH and LOADING are claimed with compare_exchange, the owner uses roms
+    int fade = FADE_BLOCKS;
+    int load_wait = 0;
+
+    static void decode_rom(const uint8_t *xzrom, int index, FV1_ROM *rom)
+    {
+        if (auto items = fv1_bank_index(xzrom))
+        {
+            xz xz(&xzrom[items[index].offset], items[index].size);
+            xz.decode((uint8_t *)rom, sizeof(FV1_ROM));
+            return;
+        }
 
-        xz xz(&this->xzrom[3], *((uint16_t *)&this->xzrom[1]));
+        xz xz(&xzrom[3], *((uint16_t *)&xzrom[1]));
 
-        if (index >= 0)
-            program = index;
-        else
-            index = 0;
+        for (int i = 0; i <= index && xz.status == XZ_OK; i++)
+            xz.decode((uint8_t *)rom, sizeof(FV1_ROM));
 
-        FV1_ROM rom;
+        xz.end();
+    }
 
-        for (int i = 0; i <= program && xz.status == XZ_OK; i++)
-        {
-            xz.decode((uint8_t *)&rom, sizeof(FV1_ROM));
-        }
+    const FV1_ROM *get_rom(uint8_t index)
+    {
+        if (auto rom = roms.find(index))
+            return rom;
 
-        xz.end();
+        auto rom = roms.reserve(index);
+        decode_rom(this->xzrom, index, rom);
+        roms.commit(rom);
+        return rom;
+    }
+
+    void load_program()
+    {
+        uint8_t index = program;
+        const FV1_ROM &rom = *get_rom(index);
+
+        machine::mfree(this->ram);
+        machine::mfree(this->fv1);
+        this->ram = nullptr;
 
         this->fv1 = fv1_init(machine::malloc);
         if (this->fv1 != nullptr) // nullptr == out_of_memory
         {
             this->ram = fv1_load(fv1, rom.program, machine::malloc);
 
-            snprintf(paramNames[0], sizeof(paramNames[0]), rom.name);
-            snprintf(paramNames[1], sizeof(paramNames[1]), rom.pot0);
-            snprintf(paramNames[2], sizeof(paramNames[2]), rom.pot1);
-            snprintf(paramNames[3], sizeof(paramNames[3]), rom.pot2);
+            snprintf(paramNames[0], sizeof(paramNames[0]), "%.*s", (int)sizeof(rom.name), rom.name);
+            snprintf(paramNames[1], sizeof(paramNames[1]), "%.*s", (int)sizeof(rom.pot0), rom.pot0);
+            snprintf(paramNames[2], sizeof(paramNames[2]), "%.*s", (int)sizeof(rom.pot1), rom.pot1);
+            snprintf(paramNames[3], sizeof(paramNames[3]), "%.*s", (int)sizeof(rom.pot2), rom.pot2);
 
-            param[1].name = rom.name;
             if (rom.props & TRIGGER_INPUT)
             {
                 inputGain = __FLT_EPSILON__;
@@ -194,14 +290,44 @@ struct FV1_Engine : public Engine
                 param[0].init("D/W", &raw, raw);
             }
 
-            int i = 1;
+            param[1].init(paramNames[1], &pot0, pot0);
+            param[2].init(paramNames[2], &pot1, pot1);
+            param[3].init(paramNames[3], &pot2, pot2);
+            param[4].init(paramNames[0], &program, index, 0, fv1_bank_count(this->xzrom) - 1); // after the pots (patch layout)
+        }
+
+        loaded_program = index;
+        fade = 0;
+        state = FADE_IN;
+    }
+
+    // Claims LOAD -> LOADING, the audio path leaves the FV1 alone until load_program() is done
+    bool claim_load()
+    {
+        uint8_t expected = LOAD;
+        return state.compare_exchange_strong(expected, LOADING);
+    }
+
+    // UI loop: loads the requested program or decodes the neighbours in advance (one decode per call)
+    void idle()
+    {
+        uint8_t expected = RUNNING;
+        if (claim_load())
+        {
+            load_program();
+        }
+        else if (state.compare_exchange_strong(expected, PREFETCH))
+        {
+            for (int index : {loaded_program - 1, loaded_program + 1, (int)loaded_program})
+            {
+                if (index < 0 || index >= fv1_bank_count(this->xzrom) || roms.find(index))
+                    continue;
 
-            if (index < 0)
-                param[i++].init(paramNames[0], &program, 0, 0, this->xzrom[0] - 1);
+                get_rom(index);
+                break;
+            }
 
-            param[i++].init(paramNames[1], &pot0, pot0);
-            param[i++].init(paramNames[2], &pot1, pot1);
-            param[i++].init(paramNames[3], &pot2, pot2);
+            state = RUNNING;
         }
     }
 
@@ -217,8 +343,9 @@ struct FV1_Engine : public Engine
         {
             if (this->xzrom)
             {
-                decode_rom();
-                loaded_program = program;
+                uint8_t current = state;
+                if (current == RUNNING || current == FADE_IN)
+                    state.compare_exchange_strong(current, FADE_OUT); // PREFETCH: next block
             }
             else
             {
@@ -227,6 +354,33 @@ struct FV1_Engine : public Engine
             }
         }
 
+        const float fade0 = (float)fade / FADE_BLOCKS;
+
+        switch (state)
+        {
+        case FADE_OUT:
+            if (--fade <= 0)
+            {
+                fade = 0;
+                load_wait = 0;
+                state = LOAD;
+            }
+            break;
+        case LOAD:
+            if (++load_wait >= LOAD_TIMEOUT && claim_load()) // not on screen, no display() calls
+                load_program();
+            break;
+        case FADE_IN:
+            if (++fade >= FADE_BLOCKS)
+            {
+                fade = FADE_BLOCKS;
+                state = RUNNING;
+            }
+            break;
+        }
+
+        const float fade1 = (float)fade / FADE_BLOCKS;
+
         if (this->io->tr > 0)
         {
             fv1_fake_cv_trig(frame.trigger, ins[0], FRAME_BUFFER_SIZE);
@@ -240,7 +394,15 @@ struct FV1_Engine : public Engine
         machine::get_audio(AUX_L, ins[0], inputGain);
         machine::get_audio(AUX_R, ins[1], inputGain);
 
-        fv1_process(fv1, ins[0], ins[1], pot0, pot1, pot2, bufferL, bufferR, FRAME_BUFFER_SIZE);
+        if (state == LOAD || state == LOADING)
+        {
+            memset(bufferL, 0, sizeof(bufferL));
+            memset(bufferR, 0, sizeof(bufferR));
+        }
+        else
+        {
+            fv1_process(fv1, ins[0], ins[1], pot0, pot1, pot2, bufferL, bufferR, FRAME_BUFFER_SIZE);
+        }
 
         if (this->io->tr > 0)
         {
@@ -250,12 +412,16 @@ struct FV1_Engine : public Engine
             machine::get_audio(AUX_R, ins[1], inputGain);
         }
 
+        float wet = raw * fade0;
+        const float wet_inc = raw * (fade1 - fade0) / FRAME_BUFFER_SIZE;
+
         for (int i = 0; i < FRAME_BUFFER_SIZE; ++i)
         {
             ins[0][i] /= inputGain;
             ins[1][i] /= inputGain;
-            bufferL[i] = raw * bufferL[i] + (1 - raw) * ins[0][i];
-            bufferR[i] = raw * bufferR[i] + (1 - raw) * ins[1][i];
+            bufferL[i] = wet * bufferL[i] + (1 - raw) * ins[0][i];
+            bufferR[i] = wet * bufferR[i] + (1 - raw) * ins[1][i];
+            wet += wet_inc;
         }
 
         of.out = bufferL;
@@ -264,17 +430,27 @@ struct FV1_Engine : public Engine
 
     void display() override
     {
+        if (this->xzrom)
+            idle();
+
         gfx::drawEngine(this, fv1 ? nullptr : machine::OUT_OF_MEMORY);
     }
+
+    void display_screensaver() override
+    {
+        if (this->xzrom)
+            idle();
+    }
 };
 
 void machine_add_fv1_bank(const char *machine, const char *engine, const uint8_t *bank, int i)
 {
     static FV1_BANK_ENTRY fv1_engins[32];
-    snprintf(fv1_engins[i].name, 32, engine);
 
     if (i < (int)LEN_OF(fv1_engins))
     {
+        // bank names may fill all 32 chars without a terminating 0
+        snprintf(fv1_engins[i].name, sizeof(fv1_engins[i].name), "%.*s", (int)sizeof(FV1_ROM::name), engine);
         fv1_engins[i].bank = bank;
         fv1_engins[i].index = i;
 
@@ -299,6 +475,14 @@ void init_fv1()
 
     if (const uint8_t *FV1_BNK0 = machine::flash_read("FV1_BNK0"))
     {
+        if (auto items = fv1_bank_index(FV1_BNK0))
+        {
+            for (int i = 0; i < fv1_bank_count(FV1_BNK0); i++)
+                machine_add_fv1_bank("FV1emu", items[i].name, FV1_BNK0, i);
+
+            return;
+        }
+
         xz xz(&FV1_BNK0[3], *((uint16_t *)&FV1_BNK0[1]));
 
         FV1_ROM tmp;
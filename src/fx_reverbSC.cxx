@@ -65,6 +65,11 @@ struct ReverbSC : public Engine
         }
     }
 
+    static size_t memory_footprint()
+    {
+        return sizeof(ReverbSC) + AUX_SIZE;
+    }
+
     ~ReverbSC() override
     {
         machine::mfree(mem);
@@ -81,6 +81,7 @@ void init_engines2()
     MACHINE_INIT(init_delay);
     MACHINE_INIT(init_fv1);
     MACHINE_INIT(init_midi_polyVA)
+    MACHINE_INIT(init_midi_polyPlaits);
     MACHINE_INIT(init_dxfm);
     MACHINE_INIT(init_open303);
     MACHINE_INIT(init_aux);
@@ -133,7 +133,7 @@ struct RND : ModulationBase
 
     RND()
     {
-        stmlib::Random::Seed(reinterpret_cast<uint32_t>(this));
+        stmlib::Random::Seed((uint32_t)reinterpret_cast<uintptr_t>(this));
 
         param[0].init("TRIG", &tr_channel, tr_channel, 0, machine::get_io_info(0));
         param[0].print_value = [&](char *tmp)
@@ -328,6 +328,14 @@ struct LFO : ModulationBase
 class EnvelopeFollower
 {
 public:
+    enum Mode : uint8_t
+    {
+        PEAK,       // per sample
+        RMS,        // mean square of the block
+        BLOCK_PEAK, // peak of the block
+        MODES,
+    };
+
     EnvelopeFollower() : envelope(0)
     {
     }
@@ -336,6 +344,8 @@ public:
     {
         a = powf(0.01f, 1.0f / (attackMs * sampleRate * 0.001f));
         r = powf(0.01f, 1.0f / (releaseMs * sampleRate * 0.001f));
+        block_a = powf(a, machine::FRAME_BUFFER_SIZE);
+        block_r = powf(r, machine::FRAME_BUFFER_SIZE);
     }
 
     float process(float sample)
@@ -349,14 +359,52 @@ public:
         return envelope;
     }
 
+    // One block of audio, returns the envelope at its end
+    float process_block(const float *in, Mode mode)
+    {
+        if (mode == PEAK)
+        {
+            for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+                process(in[i]);
+
+            return envelope;
+        }
+
+        // block level (no loop-carried dependency), the envelope advances once per block
+        float v = 0;
+        if (mode == RMS)
+        {
+            for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+                v += in[i] * in[i];
+
+            v = sqrtf(v * (1.f / machine::FRAME_BUFFER_SIZE));
+        }
+        else
+        {
+            for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+                v = std::max(v, ::fabsf(in[i]));
+        }
+
+        if (v > envelope)
+            envelope = block_a * (envelope - v) + v;
+        else
+            envelope = block_r * (envelope - v) + v;
+
+        return envelope;
+    }
+
 protected:
     float envelope;
     float a;
     float r;
+    float block_a;
+    float block_r;
 };
 
 struct EF : ModulationBase
 {
+    // source: the CV inputs (0..channels-1, as in older settings) or the audio inputs
+    // channels + mode * 2 + 0 (left) / 1 (right), followed with the detector mode
     uint8_t cv_channel = 0;
     uint8_t attack = 0;
     uint8_t release = 0;
@@ -367,6 +415,9 @@ struct EF : ModulationBase
 
     EnvelopeFollower follower_;
 
+    static constexpr const char *aux_names[] = {"AUX-L", "AUX-R"};
+    static constexpr const char *mode_names[] = {"", " RMS", " BLK"};
+
     void eeprom(std::function<void(void *, size_t)> read_write) override
     {
         read_write(&cv_channel, sizeof(cv_channel));
@@ -377,10 +428,16 @@ struct EF : ModulationBase
 
     EF()
     {
-        param[0].init("SRC", &cv_channel, cv_channel, 0, machine::get_io_info(1) - 1);
+        const int channels = machine::get_io_info(1);
+        param[0].init("SRC", &cv_channel, cv_channel, 0, channels + LEN_OF(aux_names) * EnvelopeFollower::MODES - 1);
         param[0].print_value = [&](char *tmp)
         {
-            machine::get_io_info(1, cv_channel, tmp);
+            const int channels = machine::get_io_info(1);
+            if (cv_channel < channels)
+                machine::get_io_info(1, cv_channel, tmp);
+            else
+                sprintf(tmp, "%s%s", aux_names[(cv_channel - channels) % LEN_OF(aux_names)],
+                        mode_names[(cv_channel - channels) / LEN_OF(aux_names)]);
         };
 
         param[1].init("ATT", &attack, 0);
@@ -394,16 +451,38 @@ struct EF : ModulationBase
         param[3].init(".", &attenuverter, attenuverter, -1, +1);
     }
 
-    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    float dc_block(float in)
     {
-        float in = machine::get_cv(cv_channel);
-
         // https://ccrma.stanford.edu/~jos/fp/DC_Blocker_Software_Implementations.html
         float out = in - input_ + (0.995f * output_);
         output_ = out;
         input_ = in;
+        return out;
+    }
+
+    void process(machine::Parameter &target, machine::ControlFrame &frame) override
+    {
+        const int channels = machine::get_io_info(1);
+
+        if (cv_channel < channels)
+        {
+            value = follower_.process(dc_block(machine::get_cv(cv_channel))) * 10.f;
+        }
+        else
+        {
+            const int src = cv_channel - channels;
+            auto mode = (EnvelopeFollower::Mode)std::min<int>(src / LEN_OF(aux_names), EnvelopeFollower::MODES - 1);
+
+            float block[machine::FRAME_BUFFER_SIZE] = {};
+            const int input = src % LEN_OF(aux_names); // 0 = left, 1 = right
+            machine::get_audio(input == 0 ? machine::AUX_L : machine::AUX_R, block, 1.f);
+
+            for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+                block[i] = dc_block(block[i]);
+
+            value = follower_.process_block(block, mode) * 10.f;
+        }
 
-        value = follower_.process(out) * 10.f;
         CONSTRAIN(value, 0, 10.f);
 
         target.modulate(value * attenuverter);
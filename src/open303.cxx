@@ -29,6 +29,7 @@
 #include <bitset>
 #define protected public
 #include "open303/src/wavetable_gen/rosic_MipMappedWaveTable.h"
+#include "open303/src/sequencer/rosic_AcidSequencer.h"
 
 #ifndef FLASHMEM
 #include "pgmspace.h"
@@ -74,6 +75,11 @@ struct Open303Engine : public Engine, rosic::Open303
 
     WaveTable *_square = nullptr;
 
+    static size_t memory_footprint()
+    {
+        return sizeof(Open303Engine) + sizeof(WaveTable);
+    }
+
     ~Open303Engine() override
     {
         machine::mfree(_square);
@@ -87,22 +93,90 @@ struct Open303Engine : public Engine, rosic::Open303
     float _env = 0;
     float _dec = 0;
     float _note;
+    float _osc_note = -1;
+    real_t _osc_freq = 0;
     uint8_t _waveform = 1;
     bool _gate;
 
+    // Values last pushed into rosic::Open303 (acc, cutoff, res, env, dec, waveform). The setters
+    // run exp/log for the filter and envelope coefficients, so they are only called when a knob
+    // or a modulation (both write into the bound value) moved by more than 1/4096 of the range.
+    float _applied[6] = {-1, -1, -1, -1, -1, -1};
+    real_t _cutoff_hz = 0;
+
+    bool changed(int i, float value, float range)
+    {
+        if (fabsf(value - _applied[i]) <= range * (1.f / 4096))
+            return false;
+
+        _applied[i] = value;
+        return true;
+    }
+
+    void update_parameters()
+    {
+        if (changed(5, _waveform, 0))
+            Open303::setWaveform(_waveform);
+
+        if (changed(0, _acc, 100))
+            Open303::setAccent(_acc);
+
+        if (changed(2, _res, 100))
+            Open303::setResonance(_res);
+
+        if (changed(4, _dec, 1))
+        {
+            real_t decay = linToExp(_dec, 0.0, 1.0, 200.0, 2000.0);
+            Open303::setDecay(decay);
+            Open303::setAccentDecay(decay);
+        }
+
+        bool cutoff_changed = changed(1, _cutoff, 1);
+        if (changed(3, _env, 100) || cutoff_changed)
+        {
+            // setCutoff/setEnvMod each run calculateEnvModScalerAndOffset (twice), once is enough
+            _cutoff_hz = linToExp(_cutoff, 0.0, 1.0, 314.0, 2394.0);
+            Open303::envMod = _env;
+            real_t cutoff = Open303::cutoff;
+            Open303::cutoff = _cutoff_hz;
+            Open303::calculateEnvModScalerAndOffset();
+            // the audio loop ramps from the current cutoff, a silent voice can jump
+            Open303::cutoff = Open303::idle ? _cutoff_hz : cutoff;
+        }
+    }
+
+    // Renders one block, tick() runs before every sample (sequencer events)
+    template <typename Tick>
+    void render(Tick tick)
+    {
+        if (Open303::cutoff != _cutoff_hz)
+        {
+            // per sample ramp to the new cutoff, no zipper noise on sweeps
+            const real_t step = (_cutoff_hz - Open303::cutoff) / FRAME_BUFFER_SIZE;
+            for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+            {
+                tick();
+                Open303::cutoff += step;
+                buffer[i] = Open303::getSample();
+            }
+            Open303::cutoff = _cutoff_hz;
+        }
+        else
+        {
+            for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+            {
+                tick();
+                buffer[i] = Open303::getSample();
+            }
+        }
+    }
+
     void process(const ControlFrame &frame, OutputFrame &of) override
     {
         if (_square == nullptr)
             return;
 
-        Open303::setWaveform(_waveform);
-        Open303::setAccent(_acc);
-        Open303::setCutoff(linToExp(_cutoff, 0.0, 1.0, 314.0, 2394.0));
-        Open303::setResonance(_res);
-        Open303::setEnvMod(_env);
-        Open303::setDecay(linToExp(_dec, 0.0, 1.0, 200.0, 2000.0));
-        if (_acc > 0)
-            Open303::setAccentDecay(linToExp(_dec, 0.0, 1.0, 200.0, 2000.0));
+        update_parameters();
 
         _note = (float)machine::DEFAULT_NOTE + 24 + frame.qz_voltage(this->io, _pitch) * 12;
         CONSTRAIN(_note, 0, 128);
@@ -117,10 +191,17 @@ struct Open303Engine : public Engine, rosic::Open303
             _gate = false;
         }
         else
-            Open303::oscFreq = pitchToFreq(_note, tuning);
+        {
+            // exp() only when the note changes
+            if (_note != _osc_note)
+            {
+                _osc_note = _note;
+                _osc_freq = pitchToFreq(_note, tuning);
+            }
+            Open303::oscFreq = _osc_freq;
+        }
 
-        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
-            buffer[i] = Open303::getSample();
+        render([]() {});
 
         of.push(buffer, machine::FRAME_BUFFER_SIZE);
     }
@@ -203,9 +284,153 @@ struct Open303Engine : public Engine, rosic::Open303
     }
 };
 
+// Open303 running the AcidSequencer: a 16 step pattern at the MIDI clock tempo. Notes, slides and
+// accents are scheduled on the exact sample inside the block (no trigger/gate quantization to the
+// block). Incoming clock ticks re-align the step phase, TRIG restarts the pattern, V/OCT transposes.
+struct Open303SeqEngine : public Open303Engine
+{
+    AcidSequencer sequencer;
+    uint8_t _pattern = 0;
+    int _root = machine::DEFAULT_NOTE - 12;
+    int _note_off = 0;         // samples until the gate of the current step closes
+    bool _slide = false;       // the current step slides into the next one
+    uint32_t _clock_t = 0;     // frame.t of the last MIDI clock tick
+    float _bpm = 0;
+
+    // key, octave, accent, slide, gate - C = 0
+    static constexpr int8_t _lines[][16][5] = {
+        {{0, 0, 1, 0, 1}, {0, 0, 0, 0, 1}, {0, 1, 0, 1, 1}, {0, 0, 0, 0, 1}, {3, 0, 1, 0, 1}, {0, 0, 0, 0, 0}, {0, 0, 0, 1, 1}, {10, -1, 0, 0, 1},
+         {0, 0, 1, 0, 1}, {0, 0, 0, 0, 1}, {7, 0, 0, 1, 1}, {5, 0, 0, 0, 1}, {3, 0, 1, 0, 1}, {0, 0, 0, 0, 0}, {0, 1, 0, 1, 1}, {0, 0, 0, 0, 1}},
+        {{0, -1, 1, 1, 1}, {0, 0, 0, 0, 1}, {0, 0, 0, 0, 0}, {0, -1, 0, 0, 1}, {3, 0, 0, 1, 1}, {5, 0, 1, 0, 1}, {0, 0, 0, 0, 0}, {0, -1, 0, 0, 1},
+         {7, -1, 1, 1, 1}, {7, 0, 0, 0, 1}, {0, 0, 0, 0, 0}, {0, -1, 0, 0, 1}, {10, -1, 0, 1, 1}, {0, 0, 1, 0, 1}, {3, 0, 0, 1, 1}, {0, -1, 0, 0, 1}},
+    };
+
+    Open303SeqEngine()
+    {
+        // the voice is played by the sequencer, Freq becomes the pattern select
+        param[0].init("Pattern", &_pattern, 0, 0, AcidSequencer::numPatterns - 1);
+
+        for (int p = 0; p < AcidSequencer::numPatterns; p++)
+        {
+            AcidPattern *pattern = sequencer.getPattern(p);
+            if (p < (int)LEN_OF(_lines))
+            {
+                for (int i = 0; i < AcidPattern::maxNumSteps; i++)
+                {
+                    const int8_t *s = _lines[p][i];
+                    pattern->setKey(i, s[0]);
+                    pattern->setOctave(i, s[1]);
+                    pattern->setAccent(i, s[2]);
+                    pattern->setSlide(i, s[3]);
+                    pattern->setGate(i, s[4]);
+                }
+            }
+            else
+            {
+                randomUniform(0, 1, p); // same random patterns on every boot
+                pattern->randomize();
+            }
+        }
+
+        sequencer.setSampleRate(machine::SAMPLE_RATE);
+        sequencer.setMode(AcidSequencer::HOST_SYNC);
+        sequencer.start();
+    }
+
+    static size_t memory_footprint()
+    {
+        return sizeof(Open303SeqEngine) + sizeof(WaveTable);
+    }
+
+    // rosic::Open303::getSample() sequencer part (#ifdef SEQUENCER), per engine instead of per voice
+    void tick()
+    {
+        if (_note_off > 0 && --_note_off == 0)
+        {
+            Open303::releaseNote(Open303::currentNote);
+            _gate = false;
+        }
+
+        AcidNote *note = sequencer.getNote();
+        if (note == nullptr || !note->gate)
+            return;
+
+        int key = clip(note->key + 12 * note->octave + _root, 0, 127);
+        if (_slide)
+            Open303::slideToNote(key, note->accent);
+        else
+            Open303::triggerNote(key, note->accent);
+
+        Open303::currentNote = key;
+        _gate = true;
+        _slide = note->slide && sequencer.getNextScheduledNote()->gate;
+        _note_off = _slide ? 0 : sequencer.getStepLengthInSamples();
+    }
+
+    void sync(const ControlFrame &frame)
+    {
+        float midi_bpm = 1.f / 100 * machine::get_bpm();
+        if (midi_bpm > 0 && midi_bpm != _bpm)
+        {
+            _bpm = midi_bpm;
+            sequencer.setTempo(midi_bpm / (25.f / 24));
+        }
+
+        if (frame.trigger)
+        {
+            sequencer.start();
+            _slide = false;
+        }
+        else if (frame.clock)
+        {
+            // 24ppqn, every 6th tick is a 16th step: if the next step is not due within a block
+            // of the tick, the sequencer drifted away from the clock - step now
+            if ((frame.clock % 6) == 1 && frame.t - _clock_t < 1000)
+            {
+                int step_len = roundToInt(machine::SAMPLE_RATE * beatsToSeconds(0.25, sequencer.bpm));
+                int due = sequencer.countDown;
+                if (due > machine::FRAME_BUFFER_SIZE && due < step_len - machine::FRAME_BUFFER_SIZE)
+                {
+                    sequencer.countDown = 0;
+                    sequencer.driftError = 0;
+                }
+            }
+            _clock_t = frame.t;
+        }
+
+        sequencer.activePattern = _pattern;
+    }
+
+    void process(const ControlFrame &frame, OutputFrame &of) override
+    {
+        if (_square == nullptr)
+            return;
+
+        update_parameters();
+        sync(frame);
+
+        _root = machine::DEFAULT_NOTE - 12 + roundToInt(frame.qz_voltage(this->io, 0.f) * 12);
+
+        render([&]()
+               { tick(); });
+
+        of.push(buffer, machine::FRAME_BUFFER_SIZE);
+    }
+
+    void display() override
+    {
+        Open303Engine::display();
+
+        // step position
+        int step = (sequencer.step + AcidPattern::maxNumSteps - 1) % AcidPattern::maxNumSteps;
+        gfx::drawRect(4 + step * 7, 62, 5, 2);
+    }
+};
+
 void init_open303()
 {
     machine::add<Open303Engine>(machine::SYNTH, "Open303");
+    machine::add<Open303SeqEngine>(machine::SYNTH, "Open303Seq");
 }
 
 MACHINE_INIT(init_open303);
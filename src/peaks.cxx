@@ -5,6 +5,7 @@
 #include "peaks/drums/snare_drum.h"
 #include "peaks/drums/high_hat.h"
 #include "base/HiHatsEngine.hxx"
+#include "base/SilenceDetector.hxx"
 
 using namespace machine;
 
@@ -17,6 +18,7 @@ struct PeaksEngine : public Engine
 
     peaks::GateFlags flags[FRAME_BUFFER_SIZE];
     int16_t buffer[FRAME_BUFFER_SIZE];
+    SilenceDetector _silence;
 
     PeaksEngine(uint16_t p1 = UINT16_MAX / 2,
                 uint16_t p2 = UINT16_MAX / 2,
@@ -57,8 +59,28 @@ struct PeaksEngine : public Engine
         param[3].init(param4, &params_[P4], p4);
     }
 
+    // Decayed drum without trigger/gate: no need to run the processor
+    bool skip_silent(const ControlFrame &frame, OutputFrame &of)
+    {
+        if (frame.trigger || frame.gate)
+        {
+            _silence.reset();
+            return false;
+        }
+
+        if (!_silence.silent())
+            return false;
+
+        memset(buffer, 0, sizeof(buffer));
+        of.push(buffer, LEN_OF(buffer));
+        return true;
+    }
+
     void process(const ControlFrame &frame, OutputFrame &of) override
     {
+        if (skip_silent(frame, of))
+            return;
+
         _processor.Configure(params_, peaks::CONTROL_MODE_FULL);
 
         if (frame.trigger)
@@ -77,6 +99,7 @@ struct PeaksEngine : public Engine
         }
 
         _processor.Process(flags, buffer, FRAME_BUFFER_SIZE);
+        _silence.track(buffer, LEN_OF(buffer));
 
         of.push(buffer, LEN_OF(buffer));
     }
@@ -85,6 +108,9 @@ struct PeaksEngine : public Engine
 template <>
 void PeaksEngine<peaks::FmDrum, TRIGGER_INPUT | VOCT_INPUT>::process(const ControlFrame &frame, OutputFrame &of)
 {
+    if (skip_silent(frame, of))
+        return;
+
     auto bak = params_[0];
     int val = params_[0];
     val += (frame.qz_voltage(this->io, 0.f) * INT16_MAX / 3); // CV or Midi Pitch ?!
@@ -110,6 +136,7 @@ void PeaksEngine<peaks::FmDrum, TRIGGER_INPUT | VOCT_INPUT>::process(const Contr
     }
 
     _processor.Process(flags, buffer, FRAME_BUFFER_SIZE);
+    _silence.track(buffer, LEN_OF(buffer));
 
     of.push(buffer, LEN_OF(buffer));
 }
@@ -36,11 +36,67 @@ struct PlaitsEngine : public Engine
         machine::mfree(_buffer);
     }
 
+    static constexpr size_t DEFAULT_MEM = 48;
+    static constexpr size_t WAVETABLE_MEM = 64 * sizeof(const int16_t *);
+    static constexpr size_t CHORD_MEM = plaits::kChordNumChords * plaits::kChordNumNotes + plaits::kChordNumChords + plaits::kChordNumNotes;
+
     template <class T>
-    void alloc_engine(size_t mem = 48)
+    struct EngineType
+    {
+        using type = T;
+    };
+
+    // plaits engine and its buffer size (floats) by InitArgs::engine - shared by the constructor and memory_footprint()
+    template <class F>
+    static void select_engine(uint8_t engine, F &&fn)
     {
-        _plaitsEngine = new (machine::malloc(sizeof(T))) T();
+        switch (engine)
+        {
+        case 0:
+            return fn(EngineType<plaits::VirtualAnalogEngine>(), DEFAULT_MEM);
+        case 1:
+            return fn(EngineType<plaits::WaveshapingEngine>(), DEFAULT_MEM);
+        case 2:
+            return fn(EngineType<plaits::FMEngine>(), DEFAULT_MEM);
+        case 3:
+            return fn(EngineType<plaits::GrainEngine>(), DEFAULT_MEM);
+        case 4:
+            return fn(EngineType<plaits::AdditiveEngine>(), DEFAULT_MEM);
+        case 5:
+            return fn(EngineType<plaits::WavetableEngine>(), WAVETABLE_MEM);
+        case 6:
+            return fn(EngineType<plaits::ChordEngine>(), CHORD_MEM);
+        case 13:
+            return fn(EngineType<plaits::BassDrumEngine>(), DEFAULT_MEM);
+        case 14:
+            return fn(EngineType<plaits::SnareDrumEngine>(), DEFAULT_MEM);
+        case 15:
+            return fn(EngineType<plaits::HiHatEngine>(), DEFAULT_MEM);
+        case 16:
+            return fn(EngineType<plaits::VirtualAnalogVCFEngine>(), DEFAULT_MEM);
+        }
+    }
+
+    static size_t memory_footprint(const InitArgs &args)
+    {
+        size_t size = sizeof(PlaitsEngine);
+        select_engine(args.engine, [&](auto type, size_t mem)
+                      { size += sizeof(typename decltype(type)::type) + mem * sizeof(float); });
+        return size;
+    }
+
+    template <class T>
+    void alloc_engine(size_t mem = DEFAULT_MEM)
+    {
+        void *p = machine::malloc(sizeof(T));
         _buffer = (uint8_t *)machine::malloc(mem * sizeof(float));
+        if (p == nullptr || _buffer == nullptr)
+        {
+            machine::mfree(p);
+            return;
+        }
+
+        _plaitsEngine = new (p) T();
 
         stmlib::BufferAllocator allocator;
         allocator.Init(_buffer, mem * sizeof(float));
@@ -87,39 +143,38 @@ struct PlaitsEngine : public Engine
 
         param[0].init_v_oct("Pitch", &_pitch);
 
+        select_engine(engine, [&](auto type, size_t mem)
+                      { alloc_engine<typename decltype(type)::type>(mem); });
+
         switch (engine)
         {
         case 0:
-            alloc_engine<plaits::VirtualAnalogEngine>();
             init_params("Detune", 0.5f, "Square", 0.5f, "CSAW", 0.5f, {0.8f, 0.8f, false});
             break;
         case 1:
-            alloc_engine<plaits::WaveshapingEngine>();
             init_params("Waveform", 0.8f, "Fold", 0.8f, "Asym.", 0.75f, {0.7f, 0.6f, false});
             break;
         case 2:
-            alloc_engine<plaits::FMEngine>();
             init_params("Ratio", 0.8f, "Mod", 0.8f, "Feedb.", 0.75f, {0.6f, 0.6f, false});
             break;
         case 3:
-            alloc_engine<plaits::GrainEngine>();
             init_params("Ratio", 0.8f, "Frm/Fq.", 0.8f, "Width", 0.75f, {0.7f, 0.6f, false});
             param[5].init("PD-Mix", &out_aux_mix, out_aux_mix);
             break;
         case 4:
-            alloc_engine<plaits::AdditiveEngine>();
             init_params("Bump", 0.8f, "Peak", 0.8f, "Shape", 0.75f, {0.8f, 0.8f, false});
             break;
         case 5:
-            alloc_engine<plaits::WavetableEngine>(64 * sizeof(const int16_t *));
             init_params("Bank", 0.f, "Row", 0.8f, "Column", 0.75f, {0.6f, 0.6f, false});
             param[1].init(param[1].name, param[1].value.fp, 0.0f, 0, 0.5f);
-            _plaitsEngine->LoadUserData(nullptr);
+            if (_plaitsEngine)
+                _plaitsEngine->LoadUserData(nullptr);
             break;
         case 6:
         {
-            alloc_engine<plaits::ChordEngine>(plaits::kChordNumChords * plaits::kChordNumNotes + plaits::kChordNumChords + plaits::kChordNumNotes);
             init_params("Chord", 0.5f, "Inv.", 0.5f, "Shape", 0.5f, {0.8f, 0.8f, false});
+            if (_plaitsEngine == nullptr)
+                break;
 
             auto &chord = static_cast<plaits::ChordEngine *>(_plaitsEngine)->chords_.chord_index_quantizer_.quantized_value_;
             param[1].init_presets("Chord", (uint8_t *)&chord, 8, 0,
@@ -151,20 +206,16 @@ struct PlaitsEngine : public Engine
         //     break;
         case 13:
             _base_pitch += -24.f;
-            alloc_engine<plaits::BassDrumEngine>();
             init_params(output == 0 ? "Drive" : "Punch", 0.8f, "Tone", 0.5f, "Decay", 0.5f, {0.8f, 0.8f, true});
             break;
         case 14:
-            alloc_engine<plaits::SnareDrumEngine>();
             init_params("Snappy", 0.5f, "Tone", 0.5f, "Decay", 0.5f, {0.8f, 0.8f, true});
             break;
         case 15:
-            alloc_engine<plaits::HiHatEngine>();
             init_params("Noise", 0.5f, "Tone", 0.9f, "Decay", 0.6f, {0.8f, 0.8f, true});
             break;
         // engines 2
         case 16:
-            alloc_engine<plaits::VirtualAnalogVCFEngine>();
             init_params("Harsh", 0.5f, "Cutoff", 0.5f, "Morph", 0.5f, {1.f, 1.f, false});
             out_aux_mix = 0;
             modulations.timbre_patched = false;
@@ -217,6 +268,9 @@ struct PlaitsEngine : public Engine
         if (engine >= 16)
             patch.engine = (engine - 16);
 
+        if (_plaitsEngine == nullptr)
+            return;
+
         _plaitsEngine->Reset();
 
         if (is_drum())
@@ -247,6 +301,9 @@ struct PlaitsEngine : public Engine
 
     void process(const machine::ControlFrame &frame, OutputFrame &of) override
     {
+        if (_plaitsEngine == nullptr)
+            return;
+
         float a = bufferOut[0] / 256.f;
         ONE_POLE(patch.harmonics, harmonics + a, 0.1f);
         ONE_POLE(patch.timbre, timbre + a, 0.1f);
@@ -288,7 +345,9 @@ struct PlaitsEngine : public Engine
         }
 
         modulations.note = 0;
-        voice.Render(_plaitsEngine, patch, modulations, bufferOut, bufferAux, machine::FRAME_BUFFER_SIZE);
+        for (size_t i = 0; i < machine::FRAME_BUFFER_SIZE; i += plaits::kMaxBlockSize)
+            voice.Render(_plaitsEngine, patch, modulations, &bufferOut[i], &bufferAux[i],
+                         std::min<size_t>(plaits::kMaxBlockSize, machine::FRAME_BUFFER_SIZE - i));
 
         patch.decay = last_decay;
         patch.morph = last_morph;
@@ -323,7 +382,7 @@ struct PlaitsEngine : public Engine
                 param[4].name = "Decay";
         }
 
-        gfx::drawEngine(this);
+        gfx::drawEngine(this, _plaitsEngine ? nullptr : machine::OUT_OF_MEMORY);
     }
 };
 
@@ -0,0 +1,53 @@
+#include "machine.h"
+#include "base/PolyPlaitsEngine.hxx"
+#include "plaits/dsp/engine/waveshaping_engine.h"
+#include "plaits/dsp/engine/fm_engine.h"
+#include "plaits/dsp/engine/additive_engine.h"
+#include "plaits/dsp/engine/wavetable_engine.h"
+
+using namespace machine;
+
+template <size_t N>
+struct PolyWaveshaping : public PolyPlaitsEngine<plaits::WaveshapingEngine, N>
+{
+    PolyWaveshaping() : PolyPlaitsEngine<plaits::WaveshapingEngine, N>({0.7f, 0.6f, false})
+    {
+        this->init_params("Waveform", 0.8f, "Fold", 0.8f, "Asym.", 0.75f);
+    }
+};
+
+template <size_t N>
+struct PolyFM : public PolyPlaitsEngine<plaits::FMEngine, N>
+{
+    PolyFM() : PolyPlaitsEngine<plaits::FMEngine, N>({0.6f, 0.6f, false})
+    {
+        this->init_params("Ratio", 0.8f, "Mod", 0.8f, "Feedb.", 0.75f);
+    }
+};
+
+template <size_t N>
+struct PolyHarmonic : public PolyPlaitsEngine<plaits::AdditiveEngine, N>
+{
+    PolyHarmonic() : PolyPlaitsEngine<plaits::AdditiveEngine, N>({0.8f, 0.8f, false})
+    {
+        this->init_params("Bump", 0.8f, "Peak", 0.8f, "Shape", 0.75f);
+    }
+};
+
+template <size_t N>
+struct PolyWavetable : public PolyPlaitsEngine<plaits::WavetableEngine, N, 64 * sizeof(const int16_t *)>
+{
+    PolyWavetable() : PolyPlaitsEngine<plaits::WavetableEngine, N, 64 * sizeof(const int16_t *)>({0.6f, 0.6f, false})
+    {
+        this->init_params("Bank", 0.f, "Row", 0.8f, "Column", 0.75f);
+        this->param[1].init(this->param[1].name, this->param[1].value.fp, 0.0f, 0, 0.5f);
+    }
+};
+
+void init_midi_polyPlaits()
+{
+    machine::add<PolyWaveshaping<6>>("MIDI", "WSx6");
+    machine::add<PolyFM<6>>("MIDI", "FMx6");
+    machine::add<PolyHarmonic<4>>("MIDI", "HARMx4");
+    machine::add<PolyWavetable<6>>("MIDI", "WTx6");
+}
@@ -47,6 +47,11 @@ struct ResonatorEngine : public Engine
         param[5].init("Pos", &patch.position);
     }
 
+    static size_t memory_footprint()
+    {
+        return sizeof(ResonatorEngine) + sizeof(rings::Part);
+    }
+
     ~ResonatorEngine() override
     {
         machine::mfree(part);
@@ -71,8 +76,15 @@ struct ResonatorEngine : public Engine
 
         performance_state.note += frame.qz_voltage(this->io, _pitch) * 12;
 
-        strummer.Process(input, FRAME_BUFFER_SIZE, &performance_state);
-        part->Process(performance_state, patch, input, bufferOut, bufferAux, FRAME_BUFFER_SIZE);
+        // strummer runs at block rate, the onset detector takes max. 32 samples
+        strummer.Process(input, std::min<size_t>(rings::kMaxBlockSize, FRAME_BUFFER_SIZE), &performance_state);
+
+        for (size_t i = 0; i < FRAME_BUFFER_SIZE; i += rings::kMaxBlockSize)
+        {
+            part->Process(performance_state, patch, &input[i], &bufferOut[i], &bufferAux[i],
+                          std::min<size_t>(rings::kMaxBlockSize, FRAME_BUFFER_SIZE - i));
+            performance_state.strum = false;
+        }
 
         of.out = bufferOut;
         of.aux = bufferAux;
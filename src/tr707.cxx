@@ -44,9 +44,10 @@ struct TR707 : public SampleEngine
         {"HH", HH, 0x2000, 25000, 0},
     };
 
-    TR707(int sample_num = 0) : SampleEngine()
+    TR707(int sample_num = 0, int voices = 4) : SampleEngine()
     {
         setup(_sounds, sample_num, LEN_OF(_sounds));
+        setup_voices(voices);
     }
 
     bool init() override
@@ -60,7 +61,7 @@ struct TR707_CH_OH : public HiHatsEngine
     TR707 oh;
     TR707 ch;
 
-    TR707_CH_OH() : oh(11), ch(11)
+    TR707_CH_OH() : oh(11, 1), ch(11, 1) // the hi-hats choke (HiHatsEngine envelopes)
     {
         _oh = &oh;
         _ch = &ch;
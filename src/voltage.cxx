@@ -197,6 +197,10 @@ class EFEngine : public Engine
     ModulationSource *_mod = nullptr;
     float cv = 0;
 
+    // CV: the patched aux CV input, else the audio input with the detector (see EnvelopeFollower::Mode)
+    uint8_t mode = 0;
+    static constexpr const char *mode_names[] = {"CV", "Peak", "RMS", "Block peak"};
+
 public:
     EFEngine() : Engine(OUT_EQ_VOLT | AUDIO_PROCESSOR_MONO)
     {
@@ -208,6 +212,12 @@ public:
             param[1] = _mod->param[2];       // Decay
             *_mod->param[3].value.fp = 0.8f; // Attenuverter param[2].name = "+-";
 
+            param[2].init("Mode", &mode, 0, 0, LEN_OF(mode_names) - 1);
+            param[2].print_value = [&](char *tmp)
+            {
+                sprintf(tmp, "%s", mode_names[mode]);
+            };
+
             output.init(".", &cv, 0, -1.f, 1.f);
         }
     }
@@ -224,7 +234,8 @@ public:
         cv = 0.f;
         if (this->io->aux > 0)
         {
-            *_mod->param[0].value.u8p = this->io->aux - 1;
+            // EF source: CV channel, or channels + detector * 2 + input (0 = left audio input)
+            *_mod->param[0].value.u8p = mode == 0 ? this->io->aux - 1 : machine::get_io_info(1) + (mode - 1) * 2 + 0;
             _mod->process(output, (ControlFrame &)frame);
         }
 
@@ -0,0 +1,164 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#include "arena.h"
+#include <string.h>
+
+namespace host
+{
+    void Arena::init(void *mem, size_t size)
+    {
+        uintptr_t begin = ((uintptr_t)mem + ALIGN - 1) & ~(ALIGN - 1);
+        uintptr_t end = ((uintptr_t)mem + size) & ~(ALIGN - 1);
+        _begin = (uint8_t *)begin;
+        _end = end > begin + 2 * HEADER ? (uint8_t *)end : _begin;
+        reset();
+    }
+
+    void Arena::reset()
+    {
+        if (_end == _begin)
+            return;
+
+        // one free block followed by the end marker
+        Block *b = (Block *)_begin;
+        *b = {(uint32_t)(size() - HEADER), 0, 0, 0};
+        *next(b) = {0, b->size, 0, 1};
+    }
+
+    void *Arena::alloc(size_t size, Fit fit)
+    {
+        if (_end == _begin)
+            return nullptr;
+
+        const uint32_t need = HEADER + ((size + ALIGN - 1) & ~(ALIGN - 1));
+
+        Block *b = nullptr;
+        for (Block *it = (Block *)_begin; it->size; it = next(it))
+        {
+            if (it->used || it->size < need)
+                continue;
+
+            b = it;
+            if (fit == FIRST_FIT)
+                break;
+        }
+
+        if (b)
+        {
+            if (b->size >= need + HEADER + ALIGN) // split
+            {
+                if (fit == LAST_FIT) // the free rest stays below
+                {
+                    b->size -= need;
+                    Block *top = next(b);
+                    *top = {need, b->size, 0, 0};
+                    next(top)->prev = need;
+                    b = top;
+                }
+                else
+                {
+                    Block *rest = (Block *)((uint8_t *)b + need);
+                    *rest = {b->size - need, need, 0, 0};
+                    next(rest)->prev = rest->size;
+                    b->size = need;
+                }
+            }
+
+            b->used = 1;
+            b->requested = size;
+            memset(b + 1, 0, b->size - HEADER);
+            return b + 1;
+        }
+
+        return nullptr;
+    }
+
+    void Arena::free(void *p)
+    {
+        if (p == nullptr)
+            return;
+
+        Block *b = (Block *)p - 1;
+        b->used = 0;
+        b->requested = 0;
+
+        Block *n = next(b);
+        if (n->size && !n->used) // merge with the next block
+        {
+            b->size += n->size;
+            next(b)->prev = b->size;
+        }
+
+        if (b->prev)
+        {
+            Block *prev = (Block *)((uint8_t *)b - b->prev);
+            if (!prev->used) // merge into the previous block
+            {
+                prev->size += b->size;
+                next(prev)->prev = prev->size;
+            }
+        }
+    }
+
+    size_t Arena::size_of(const void *p) const
+    {
+        return ((const Block *)p - 1)->requested;
+    }
+
+    size_t Arena::used() const
+    {
+        size_t n = 0;
+        if (_end != _begin)
+            for (Block *b = (Block *)_begin; b->size; b = next(b))
+                n += b->requested;
+        return n;
+    }
+
+    size_t Arena::free_bytes() const
+    {
+        size_t n = 0;
+        if (_end != _begin)
+            for (Block *b = (Block *)_begin; b->size; b = next(b))
+                n += b->used ? 0 : b->size;
+        return n;
+    }
+
+    size_t Arena::largest_free() const
+    {
+        size_t n = 0;
+        if (_end != _begin)
+            for (Block *b = (Block *)_begin; b->size; b = next(b))
+                if (!b->used && b->size > n)
+                    n = b->size;
+        return n;
+    }
+
+    float Arena::fragmentation() const
+    {
+        size_t total = free_bytes();
+        return total ? 1.f - (float)largest_free() / total : 0.f;
+    }
+} // namespace host
@@ -0,0 +1,89 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace host
+{
+    // First-fit heap with boundary tags in a fixed region. Models the T4 heap (heap budget)
+    // and serves as the arena of an engine slot, which is released as a whole on engine change.
+    class Arena
+    {
+    public:
+        static constexpr size_t HEADER = 16;
+        static constexpr size_t ALIGN = 16;
+
+        void init(void *mem, size_t size);
+
+        enum Fit
+        {
+            FIRST_FIT, // lowest free block
+            LAST_FIT,  // top of the highest free block
+        };
+
+        // Zero initialized, nullptr if there is no free block large enough
+        void *alloc(size_t size, Fit fit = FIRST_FIT);
+        void free(void *p);
+        void reset(); // drops all blocks
+
+        bool contains(const void *p) const
+        {
+            return p >= _begin && p < _end;
+        }
+
+        size_t size() const
+        {
+            return _end - _begin;
+        }
+
+        size_t size_of(const void *p) const; // requested size of the block
+        size_t used() const;                 // requested bytes of all blocks
+        size_t free_bytes() const;           // sum of the free blocks (incl. headers)
+        size_t largest_free() const;
+
+        // 0 = all free memory is contiguous, ->1 = free memory is split into small holes
+        float fragmentation() const;
+
+    private:
+        struct Block
+        {
+            uint32_t size; // incl. header, 0 = end of arena
+            uint32_t prev; // size of the previous block, 0 = first block
+            uint32_t requested;
+            uint32_t used;
+        };
+
+        Block *next(Block *b) const
+        {
+            return (Block *)((uint8_t *)b + b->size);
+        }
+
+        uint8_t *_begin = nullptr;
+        uint8_t *_end = nullptr;
+    };
+} // namespace host
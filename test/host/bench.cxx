@@ -0,0 +1,253 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+
+// Cycle budget benchmark: measures process() per block for every engine and every preset
+// and writes a CSV table (one line per engine/preset, stable order -> diffable between commits)
+//
+//   bench [-s seconds] [-o file.csv] [-f flashdir] [-x factor] [-w] [engine-filter ...]
+//
+// budget_% is relative to the real-time budget of one block (FRAME_BUFFER_SIZE / SAMPLE_RATE = 500us).
+// The factor (-x) scales the host timings to the target, four engines share the budget of one module.
+//
+// -w (worst case): one line per engine (preset = *), driven with a trigger + note on every block,
+// all parameters jumping through their range and a preset change every block. A single
+// overlong block is an audible click, so max_ns is the number that matters here.
+
+#include "host.h"
+#include <chrono>
+#include <unistd.h>
+
+using namespace machine;
+
+constexpr double BLOCK_BUDGET_NS = 1e9 * FRAME_BUFFER_SIZE / SAMPLE_RATE;
+constexpr int ENGINES_PER_MODULE = 4;
+
+struct Result
+{
+    double mean_ns = 0;
+    double max_ns = 0;
+    uint32_t max_block = 0;
+};
+
+// Adversarial control sequence for the worst case mode, the aux/CV noise burst at full level every block
+static void burst(host::Stimulus &stimulus, uint32_t t, ControlFrame &frame, Engine *engine)
+{
+    stimulus.burst = 0.8f;
+    stimulus.next(t, frame, engine);
+
+    frame.trigger = true;
+    frame.gate = t & 1;
+    frame.accent = t & 1;
+    frame.clock = 1 + t % 24;
+    host::trigger_input = 0xF;
+    host::gate_input = frame.gate ? 0xF : 0;
+
+    int i = 0;
+    for (auto &p : engine->param)
+    {
+        // every parameter jumps across its range, the preset parameter steps through all presets
+        if (p.flags & Parameter::IS_PRESET)
+        {
+            *p.value.u8p = p.min + t % ((int)(p.max - p.min) + 1);
+            if (p.value_changed)
+                p.value_changed();
+        }
+        else if (p.type != Parameter::NONE)
+        {
+            p.from_float((float)((t * 7 + i * 13) % 32) / 31);
+        }
+        i++;
+    }
+
+    if (engine->props & MIDI_ENGINE)
+    {
+        auto midi = static_cast<MidiEngine *>(engine);
+        midi->onMidiNote(DEFAULT_NOTE + (t + 11) % 12, 0);
+        midi->onMidiNote(DEFAULT_NOTE + t % 12, 100);
+    }
+}
+
+static Result measure(Engine *engine, uint32_t blocks, bool worst_case)
+{
+    host::Stimulus stimulus;
+    ControlFrame frame;
+    Result r;
+    double sum = 0;
+
+    for (uint32_t t = 0; t < blocks; t++)
+    {
+        if (worst_case)
+            burst(stimulus, t, frame, engine);
+        else
+            stimulus.next(t, frame, engine);
+
+        OutputFrame of;
+        auto t0 = std::chrono::steady_clock::now();
+        engine->process(frame, of);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+        sum += ns;
+        if (ns > r.max_ns)
+        {
+            r.max_ns = ns;
+            r.max_block = t;
+        }
+    }
+
+    r.mean_ns = blocks ? sum / blocks : 0;
+    return r;
+}
+
+static std::string csv_escape(const char *s)
+{
+    std::string r = "\"";
+    for (; s && *s; s++)
+    {
+        if (*s == '"')
+            r += '"';
+        r += *s;
+    }
+    return r + "\"";
+}
+
+int main(int argc, char **argv)
+{
+    float seconds = 1.f;
+    float factor = 1.f;
+    const char *outfile = nullptr;
+    bool worst_case = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:o:f:x:w")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            seconds = atof(optarg);
+            break;
+        case 'o':
+            outfile = optarg;
+            break;
+        case 'f':
+            host::flash_dir = optarg;
+            break;
+        case 'x':
+            factor = atof(optarg);
+            break;
+        case 'w':
+            worst_case = true;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s seconds] [-o file.csv] [-f flashdir] [-x factor] [-w] [engine-filter ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *csv = outfile ? fopen(outfile, "w") : stdout;
+    if (csv == nullptr)
+    {
+        perror(outfile);
+        return 1;
+    }
+
+    host::init_engines();
+
+    const uint32_t blocks = seconds * host::BLOCKS_PER_SECOND;
+    int over_budget = 0;
+
+    fprintf(csv, "machine,engine,preset,preset_name,mean_ns,max_ns,max_block,mean_budget_%%,max_budget_%%,fits_%dx\n", ENGINES_PER_MODULE);
+
+    for (auto &entry : host::engines())
+    {
+        if (!host::matches(entry, argc - optind, &argv[optind]))
+            continue;
+
+        IO io;
+        io.aux = 1;
+        Engine *engine = host::create_engine(entry, &io);
+        if (engine == nullptr)
+        {
+            fprintf(stderr, "%s/%s: SKIPPED (init failed - missing flash data?)\n", entry.machine, entry.name);
+            continue;
+        }
+
+        Parameter *preset = worst_case ? nullptr : host::preset_param(engine);
+        const int count = preset ? (int)(preset->max - preset->min) + 1 : 1;
+
+        for (int i = 0; i < count; i++)
+        {
+            // Every preset starts from a fresh engine, the way the firmware loads a slot
+            if (i > 0)
+            {
+                host::destroy_engine(engine);
+                engine = host::create_engine(entry, &io);
+                if (engine == nullptr)
+                    break;
+                preset = host::preset_param(engine);
+            }
+
+            if (preset)
+            {
+                *preset->value.u8p = preset->min + i;
+                if (preset->value_changed)
+                    preset->value_changed();
+            }
+
+            Result r = measure(engine, blocks, worst_case);
+            r.mean_ns *= factor;
+            r.max_ns *= factor;
+
+            char name[64] = {};
+            if (preset && preset->print_value)
+                preset->print_value(name);
+            else if (preset && preset->name)
+                snprintf(name, sizeof(name), "%s", preset->name);
+
+            const double mean_pct = 100 * r.mean_ns / BLOCK_BUDGET_NS;
+            const double max_pct = 100 * r.max_ns / BLOCK_BUDGET_NS;
+            const bool fits = max_pct <= 100.0 / ENGINES_PER_MODULE;
+            if (max_pct > 100)
+                over_budget++;
+
+            std::string index = worst_case ? "*" : std::to_string(preset ? (int)preset->min + i : -1);
+
+            fprintf(csv, "%s,%s,%s,%s,%.0f,%.0f,%u,%.2f,%.2f,%d\n",
+                    csv_escape(entry.machine).c_str(), csv_escape(entry.name).c_str(), index.c_str(),
+                    csv_escape(name).c_str(), r.mean_ns, r.max_ns, r.max_block, mean_pct, max_pct, fits ? 1 : 0);
+            fflush(csv);
+        }
+
+        host::destroy_engine(engine);
+    }
+
+    if (csv != stdout)
+        fclose(csv);
+
+    if (over_budget)
+        fprintf(stderr, "%d engine/preset(s) exceed the block budget (worst case)\n", over_budget);
+
+    return 0;
+}
@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+#
+# Compares two bench.csv files (see bench.cxx) and lists the engine/presets whose
+# worst case or mean cost increased by more than the threshold.
+#
+#   bench_compare.py [-t percent] old.csv new.csv
+#
+# Exit code 1 if a regression was found or an engine/preset fits no longer 4x into a module.
+
+import argparse
+import csv
+import sys
+
+parser = argparse.ArgumentParser()
+parser.add_argument("-t", "--threshold", type=float, default=10, help="allowed increase in percent")
+parser.add_argument("old")
+parser.add_argument("new")
+args = parser.parse_args()
+
+
+def load(path):
+    with open(path, newline="") as f:
+        return {(r["machine"], r["engine"], r["preset"]): r for r in csv.DictReader(f)}
+
+
+old = load(args.old)
+new = load(args.new)
+fits = [k for k in new[next(iter(new))].keys() if k.startswith("fits_")][0] if new else "fits_4x"
+
+failed = 0
+for key, n in new.items():
+    o = old.get(key)
+    if o is None:
+        continue
+
+    for col in ("mean_ns", "max_ns"):
+        a, b = float(o[col]), float(n[col])
+        if a > 0 and (b - a) * 100 / a > args.threshold:
+            print("%s/%s [%s %s] %s: %.0f -> %.0f (+%.1f%%)" % (key[0], key[1], key[2], n["preset_name"], col, a, b, (b - a) * 100 / a))
+            failed += 1
+
+    if o.get(fits) == "1" and n.get(fits) == "0":
+        print("%s/%s [%s %s] does not fit %s anymore (%s%% worst case)" % (key[0], key[1], key[2], n["preset_name"], fits, n["max_budget_%"]))
+        failed += 1
+
+for key in old.keys() - new.keys():
+    print("%s/%s [%s] missing" % key)
+
+sys.exit(1 if failed else 0)
@@ -0,0 +1,151 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// FmOpKernel micro benchmark: the operator kernels of lib/msfa/fm_op_kernel.cc per N samples.
+// The second part measures a complete Dx7Note (six operators, envelopes, LFO) playing the first
+// patch of plaits::fm_patches_table, to state how many DX7 voices fit into one block / one slot.
+//
+//   bench_fm [iterations] [factor]
+//
+// The factor scales the host timings to the target (like bench_voices -x).
+
+#include "msfa/synth.h"
+#include "msfa/sin.h"
+#include "msfa/fm_op_kernel.h"
+#include "msfa/dx7note.h"
+#include "msfa/exp2.h"
+#include "msfa/freqlut.h"
+#include "msfa/lfo.h"
+#include "msfa/pitchenv.h"
+#include "msfa/env.h"
+#include "msfa/porta.h"
+#include "msfa/patch.h"
+#include "plaits/resources.h"
+#include "machine.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+struct Args
+{
+    int32_t phase, freq, gain1, gain2;
+    bool add;
+};
+
+// Best of 7 runs, the host timing is noisy
+template <typename F>
+static double measure(int iterations, const Args *args, F fn)
+{
+    double best = 1e12;
+    for (int r = 0; r < 7; r++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            fn(args[i & 255]);
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / iterations);
+    }
+    return best;
+}
+
+constexpr double BLOCK_BUDGET_NS = 1e9 * machine::FRAME_BUFFER_SIZE / machine::SAMPLE_RATE;
+constexpr int ENGINES_PER_MODULE = 4;
+
+// One held DX7 note, re-triggered every second so the envelopes never reach the (cheap) silent end
+static double measure_voice(int iterations)
+{
+    Exp2::init();
+    Tanh::init();
+    Freqlut::init(machine::SAMPLE_RATE);
+    Lfo::init(machine::SAMPLE_RATE);
+    PitchEnv::init(machine::SAMPLE_RATE);
+    Env::init_sr(machine::SAMPLE_RATE);
+    Porta::init_sr(machine::SAMPLE_RATE);
+
+    static uint8_t data[156];
+    UnpackPatch((const char *)plaits::fm_patches_table[0], (char *)data);
+
+    static Controllers controllers;
+    controllers.values_[kControllerPitch] = 0x2000;
+    controllers.masterTune = 0;
+    controllers.opSwitch = 0x3f;
+    controllers.refresh();
+
+    static FmCore fm_core;
+    static Lfo lfo;
+    static Dx7Note note;
+    static int32_t buf[N];
+    lfo.reset(data + 6 * 21 + 11); // LFO_RATE()
+
+    const int retrigger = machine::SAMPLE_RATE / N;
+    double best = 1e12;
+    for (int r = 0; r < 7; r++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            if (i % retrigger == 0)
+            {
+                note.init(data, 48 + (i / retrigger) % 24, 100);
+                lfo.keydown();
+            }
+            memset(buf, 0, sizeof(buf));
+            note.compute(buf, &fm_core, lfo.getsample(), lfo.getdelay(), &controllers);
+        }
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / iterations);
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 200000;
+    const double factor = argc > 2 ? atof(argv[2]) : 1.0;
+
+    static Args args[256];
+    static int32_t input[N], out[N];
+
+    srand(1);
+    for (auto &a : args)
+        a = {rand() << 1, rand() >> 4, rand() >> 7, rand() >> 7, (rand() & 1) != 0};
+    for (auto &s : input)
+        s = (rand() - RAND_MAX / 2) << 2;
+
+    double ns = measure(iterations, args, [&](const Args &a)
+                        { FmOpKernel::compute(out, input, a.phase, a.freq, a.gain1, a.gain2, a.add); });
+    printf("compute       %6.1f ns per %d samples (x%.1f)\n", ns * factor, N, factor);
+
+    ns = measure(iterations, args, [&](const Args &a)
+                 { FmOpKernel::compute_pure(out, a.phase, a.freq, a.gain1, a.gain2, a.add); });
+    printf("compute_pure  %6.1f ns per %d samples (x%.1f)\n", ns * factor, N, factor);
+
+    // per FRAME_BUFFER_SIZE block, msfa renders N samples at once
+    const double voice = measure_voice(iterations / 8) * machine::FRAME_BUFFER_SIZE / N * factor;
+    printf("Dx7Note       %6.1f ns per %d samples (x%.1f), %.1f voices per block, %.1f per slot\n",
+           voice, machine::FRAME_BUFFER_SIZE, factor, BLOCK_BUDGET_NS / voice, BLOCK_BUDGET_NS / ENGINES_PER_MODULE / voice);
+
+    return 0;
+}
@@ -0,0 +1,437 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// FV-1 program benchmark (lib/fv1/FV1.cc): every program runs with the switch interpreter and
+// with the threaded code, both outputs have to be bit exact. Reports time and cycles per sample.
+//
+//   bench_fv1 [-s seconds] [-p pot0,pot1,pot2] [-d dir] [rom.bin ...]
+//
+// rom.bin: FV1_ROM images (640 bytes, see fv1_bank.py extract) or raw programs (512 bytes)
+//
+// -d writes the input, the programs and their output to dir, fv1_ref.py compares it with FV1.S.
+// The compiled programs of fv1_programs[] (fv1_set_fx) are included as "fx:N".
+
+#include "machine.h"
+#include "fv1/FV1.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" bool fv1_threaded;
+
+// Instruction encoding (SpinASM)
+namespace asm_fv1
+{
+    enum
+    {
+        SIN0 = 0,
+        SIN1 = 1,
+        RMP0 = 2,
+        SIN0_RATE = 0x00,
+        SIN0_RANGE = 0x01,
+        RMP0_RATE = 0x04,
+        RMP0_RANGE = 0x05,
+        POT0 = 0x10,
+        POT1 = 0x11,
+        POT2 = 0x12,
+        ADCL = 0x14,
+        ADCR = 0x15,
+        DACL = 0x16,
+        DACR = 0x17,
+        ADDR_PTR = 0x18,
+        REG0 = 0x20,
+        // SKP
+        NEG = 0x01,
+        GEZ = 0x02,
+        ZRO = 0x04,
+        ZRC = 0x08,
+        RUN = 0x10,
+        // CHO
+        REG = 0x02,
+        COMPC = 0x04,
+        RPTR2 = 0x10,
+        NA = 0x20,
+    };
+
+    static uint32_t s1_14(float c) { return ((uint32_t)(int32_t)(c * 16384.f) & 0xFFFF) << 16; }
+    static uint32_t s1_9(float c) { return ((uint32_t)(int32_t)(c * 512.f) & 0x7FF) << 21; }
+    static uint32_t s_10(float d) { return ((uint32_t)(int32_t)(d * 1024.f) & 0x7FF) << 5; }
+
+    static uint32_t rda(int addr, float c) { return s1_9(c) | (addr & 0x7FFF) << 5 | 0x00; }
+    static uint32_t rmpa(float c) { return s1_9(c) | 0x01; }
+    static uint32_t wra(int addr, float c) { return s1_9(c) | (addr & 0x7FFF) << 5 | 0x02; }
+    static uint32_t wrap(int addr, float c) { return s1_9(c) | (addr & 0x7FFF) << 5 | 0x03; }
+    static uint32_t rdax(int reg, float c) { return s1_14(c) | reg << 5 | 0x04; }
+    static uint32_t rdfx(int reg, float c) { return s1_14(c) | reg << 5 | 0x05; }
+    static uint32_t wrax(int reg, float c) { return s1_14(c) | reg << 5 | 0x06; }
+    static uint32_t wrhx(int reg, float c) { return s1_14(c) | reg << 5 | 0x07; }
+    static uint32_t wrlx(int reg, float c) { return s1_14(c) | reg << 5 | 0x08; }
+    static uint32_t maxx(int reg, float c) { return s1_14(c) | reg << 5 | 0x09; }
+    static uint32_t mulx(int reg) { return reg << 5 | 0x0A; }
+    static uint32_t log(float c, float d) { return s1_14(c) | s_10(d / 16) | 0x0B; }
+    static uint32_t exp(float c, float d) { return s1_14(c) | s_10(d) | 0x0C; }
+    static uint32_t sof(float c, float d) { return s1_14(c) | s_10(d) | 0x0D; }
+    static uint32_t and_(uint32_t mask) { return (mask & 0xFFFFFF) << 8 | 0x0E; }
+    static uint32_t or_(uint32_t mask) { return (mask & 0xFFFFFF) << 8 | 0x0F; }
+    static uint32_t xor_(uint32_t mask) { return (mask & 0xFFFFFF) << 8 | 0x10; }
+    static uint32_t skp(int flags, int n) { return flags << 27 | n << 21 | 0x11; }
+    static uint32_t wlds(int sel, int freq, int amp) { return sel << 29 | freq << 20 | amp << 5 | 0x12; }
+    static uint32_t wldr(int sel, int rate, int amp) { return 1u << 30 | sel << 29 | (rate & 0xFFFF) << 13 | amp << 5 | 0x12; }
+    static uint32_t jam(int sel) { return sel << 6 | 0x13; }
+    static uint32_t cho_rda(int n, int flags, int addr) { return flags << 24 | n << 21 | (addr & 0xFFFF) << 5 | 0x14; }
+    static uint32_t cho_sof(int n, int flags, int d) { return 2u << 30 | flags << 24 | n << 21 | (d & 0xFFFF) << 5 | 0x14; }
+    static uint32_t cho_rdal(int n) { return 3u << 30 | n << 21 | 0x14; }
+} // namespace asm_fv1
+
+struct Program
+{
+    std::string name;
+    uint8_t code[512];
+    int size;
+    int fx = -1; // fv1_programs[fx] instead of code
+};
+
+static Program assemble(const char *name, std::initializer_list<uint32_t> words)
+{
+    Program p = {name, {}, 0};
+    for (int i = 0; i < 128; i++)
+    {
+        uint32_t w = i < (int)words.size() ? words.begin()[i] : 0x11;
+        p.code[i * 4 + 0] = w >> 24;
+        p.code[i * 4 + 1] = w >> 16;
+        p.code[i * 4 + 2] = w >> 8;
+        p.code[i * 4 + 3] = w;
+    }
+    p.size = words.size();
+    return p;
+}
+
+static std::vector<Program> builtin_programs()
+{
+    using namespace asm_fv1;
+    std::vector<Program> programs;
+
+    programs.push_back(assemble("passthru", {
+                                                rdax(ADCL, 1.f),
+                                                wrax(DACL, 0.f),
+                                                rdax(ADCR, 1.f),
+                                                wrax(DACR, 0.f),
+                                            }));
+
+    programs.push_back(assemble("echo", {
+                                            rdax(ADCL, 0.5f),
+                                            rda(12000, 0.6f),
+                                            wra(0, 1.f),
+                                            rdfx(REG0, 0.3f),
+                                            wrlx(REG0, -1.f),
+                                            wrax(DACL, 1.f),
+                                            wrax(DACR, 0.f),
+                                        }));
+
+    programs.push_back(assemble("reverb", {
+                                              skp(RUN, 2),
+                                              wlds(SIN0, 12, 160),
+                                              wldr(RMP0, 4096, 0),
+                                              rdax(ADCL, 0.25f),
+                                              rdax(ADCR, 0.25f),
+                                              rda(156, 0.5f),
+                                              wrap(0, -0.5f),
+                                              rda(156 + 223, 0.5f),
+                                              wrap(157, -0.5f),
+                                              rda(380 + 434, 0.5f),
+                                              wrap(380, -0.5f),
+                                              rda(815 + 668, 0.5f),
+                                              wrap(815, -0.5f),
+                                              wrax(REG0, 0.f),
+                                              rda(6000, 0.7f),
+                                              rdax(REG0, 1.f),
+                                              rda(2000 + 1001, 0.6f),
+                                              wrap(2000, -0.6f),
+                                              wra(3100, 0.f),
+                                              cho_rda(SIN0, REG | COMPC, 4200),
+                                              cho_rda(SIN0, 0, 4201),
+                                              wra(4300, 0.f),
+                                              cho_rda(RMP0, REG | COMPC, 5000),
+                                              cho_rda(RMP0, RPTR2, 5000),
+                                              cho_sof(RMP0, NA | COMPC, 0),
+                                              cho_rda(RMP0, NA, 5000 + 128),
+                                              wrax(REG0 + 1, 0.f),
+                                              rda(3100 + 2900, 0.8f),
+                                              rda(4300 + 1200, 0.4f),
+                                              rdax(REG0 + 1, 0.3f),
+                                              wrax(DACL, 1.f),
+                                              wrax(DACR, 0.f),
+                                              rdax(ADCL, 1.f),
+                                              wra(6100, 0.f),
+                                              rmpa(1.f),
+                                              wra(8000, 0.f),
+                                          }));
+
+    programs.push_back(assemble("dynamics", {
+                                                skp(RUN, 1),
+                                                wlds(SIN1, 40, 8000),
+                                                rdax(ADCL, 1.f),
+                                                maxx(0, 0.f),
+                                                rdfx(REG0, 0.001f),
+                                                wrax(REG0, 1.f),
+                                                log(1.f, 0.f),
+                                                sof(-0.5f, 0.f),
+                                                exp(1.f, 0.f),
+                                                mulx(ADCL),
+                                                wrax(REG0 + 1, 1.f),
+                                                skp(NEG, 2),
+                                                sof(1.f, 0.125f),
+                                                skp(0, 1),
+                                                sof(0.f, -0.125f),
+                                                and_(0xFFFF00),
+                                                or_(0x000010),
+                                                xor_(0x000100),
+                                                wrhx(REG0 + 2, -0.5f),
+                                                cho_rdal(SIN1),
+                                                mulx(REG0 + 1),
+                                                skp(ZRO | GEZ, 1),
+                                                sof(-1.f, 0.f),
+                                                skp(ZRC, 1),
+                                                jam(0),
+                                                wrax(DACL, 0.f),
+                                                rdax(POT0, 1.f),
+                                                mulx(ADCR),
+                                                wrax(DACR, 0.f),
+                                                rdax(POT1, 0.5f),
+                                                sof(1.f, 0.f),
+                                                wrax(ADDR_PTR, 0.f),
+                                            }));
+
+    return programs;
+}
+
+static bool load_rom(const char *path, Program &p)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == nullptr)
+        return false;
+
+    uint8_t buffer[128 + 512];
+    size_t n = fread(buffer, 1, sizeof(buffer), f);
+    fclose(f);
+
+    if (n == 512)
+    {
+        p.name = path;
+        memcpy(p.code, buffer, 512);
+    }
+    else if (n == sizeof(buffer)) // FV1_ROM
+    {
+        char name[33] = {};
+        memcpy(name, &buffer[1], 32);
+        p.name = name;
+        memcpy(p.code, &buffer[128], 512);
+    }
+    else
+        return false;
+
+    p.size = 0;
+    while (p.size < 128 && memcmp(&p.code[p.size * 4], "\0\0\0\x11", 4) != 0)
+        p.size++;
+
+    return true;
+}
+
+struct Result
+{
+    double ns;
+    double cycles;
+};
+
+static uint64_t cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Best of 5 runs, the host timing is noisy
+static float pots[3] = {0.5f, 0.25f, 0.75f};
+
+static Result run(const Program &p, bool threaded, const std::vector<float> &in, std::vector<float> &outL, std::vector<float> &outR)
+{
+    constexpr int N = machine::FRAME_BUFFER_SIZE;
+    Result best = {1e12, 1e12};
+
+    for (int r = 0; r < 5; r++)
+    {
+        fv1_threaded = threaded;
+        FV1 *fv1 = fv1_init(malloc);
+        void *instr = nullptr;
+        if (p.fx >= 0)
+            fv1_set_fx(fv1, p.fx);
+        else
+            instr = fv1_load(fv1, p.code, malloc);
+
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = cycles();
+        for (size_t i = 0; i + N <= in.size(); i += N)
+            fv1_process(fv1, &in[i], &in[i], pots[0], pots[1], pots[2], &outL[i], &outR[i], N);
+        uint64_t c1 = cycles();
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+        best.ns = std::min(best.ns, ns / in.size());
+        best.cycles = std::min(best.cycles, (double)(c1 - c0) / in.size());
+
+        free(instr);
+        free(fv1);
+    }
+
+    return best;
+}
+
+static bool write_file(const std::string &path, const void *data, size_t size)
+{
+    FILE *f = fopen(path.c_str(), "wb");
+    if (f == nullptr)
+        return false;
+
+    bool ok = fwrite(data, 1, size, f) == size;
+    fclose(f);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    float seconds = 1;
+    const char *dump_dir = nullptr;
+    std::vector<Program> programs = builtin_programs();
+
+    for (int fx = 0; fx < 256; fx++)
+    {
+        if (fv1_programs[fx] != nullptr)
+        {
+            Program p = {"fx:" + std::to_string(fx), {}, 0};
+            p.fx = fx;
+            programs.push_back(p);
+        }
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "-p") && i + 1 < argc)
+            sscanf(argv[++i], "%f,%f,%f", &pots[0], &pots[1], &pots[2]);
+        else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+            dump_dir = argv[++i];
+        else
+        {
+            Program p;
+            if (!load_rom(argv[i], p))
+            {
+                fprintf(stderr, "%s: no FV1_ROM/program\n", argv[i]);
+                return 1;
+            }
+            programs.push_back(p);
+        }
+    }
+
+    std::vector<float> in(machine::SAMPLE_RATE * seconds);
+    uint32_t noise = 1;
+    float burst = 0;
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        if ((i % (machine::SAMPLE_RATE / 2)) == 0)
+            burst = 0.8f;
+        noise = noise * 1664525L + 1013904223L;
+        in[i] = (float)(int32_t)noise / INT32_MAX * burst;
+        burst *= 0.9995f;
+    }
+
+    std::vector<float> switchL(in.size()), switchR(in.size()), threadedL(in.size()), threadedR(in.size());
+
+    const double budget = 1e9 / machine::SAMPLE_RATE;
+    int errors = 0;
+
+    FILE *manifest = nullptr;
+    if (dump_dir != nullptr)
+    {
+        manifest = fopen((std::string(dump_dir) + "/manifest.txt").c_str(), "w");
+        if (manifest == nullptr || !write_file(std::string(dump_dir) + "/input.raw", in.data(), in.size() * sizeof(float)))
+        {
+            fprintf(stderr, "%s: can't write\n", dump_dir);
+            return 1;
+        }
+        fprintf(manifest, "%d %.9g,%.9g,%.9g\n", machine::FRAME_BUFFER_SIZE, pots[0], pots[1], pots[2]);
+    }
+
+    printf("program,instructions,switch_ns,threaded_ns,speedup,threaded_cycles,budget_percent,rms\n");
+    for (auto &p : programs)
+    {
+        Result a = run(p, false, in, switchL, switchR);
+        Result b = run(p, true, in, threadedL, threadedR);
+
+        bool exact = switchL == threadedL && switchR == threadedR;
+        double rms = 0;
+        for (size_t i = 0; i < in.size(); i++)
+        {
+            exact &= (threadedL[i] == threadedL[i]) && (threadedR[i] == threadedR[i]); // NaN
+            rms += threadedL[i] * threadedL[i] + threadedR[i] * threadedR[i];
+        }
+        rms = sqrt(rms / (2 * in.size()));
+
+        printf("%s,%d,%.1f,%.1f,%.2f,%.0f,%.3f,%.4f%s\n", p.name.c_str(), p.size, a.ns, b.ns, a.ns / b.ns, b.cycles,
+               b.ns * 100 / budget, rms, exact ? "" : ",MISMATCH");
+        errors += !exact;
+
+        if (manifest != nullptr)
+        {
+            // output: L/R interleaved, program: raw 512 bytes or fx:N
+            char file[16];
+            sprintf(file, "%02d", (int)(&p - &programs[0]));
+            std::vector<float> out;
+            for (size_t i = 0; i < in.size(); i++)
+            {
+                out.push_back(threadedL[i]);
+                out.push_back(threadedR[i]);
+            }
+            write_file(std::string(dump_dir) + "/" + file + ".out", out.data(), out.size() * sizeof(float));
+            if (p.fx < 0)
+                write_file(std::string(dump_dir) + "/" + file + ".prog", p.code, sizeof(p.code));
+            fprintf(manifest, "%s.out %s %s\n", file, p.fx < 0 ? (std::string(file) + ".prog").c_str() : p.name.c_str(), p.name.c_str());
+        }
+    }
+
+    if (manifest != nullptr)
+        fclose(manifest);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// Modulation cost of a heavily modulated configuration: 4 slots with a modulation source on every
+// parameter (LFO, ENV, CV, RND, EF round robin), evaluated by the ModulationMatrix before the
+// engines run. -1: one LFO shared by all parameters (evaluated once per block).
+//
+//   bench_mod [-s seconds] [-1] [-f flashdir] [engine-filter ...]
+
+#include "host.h"
+#include <chrono>
+#include <unistd.h>
+
+using namespace machine;
+
+constexpr int SLOTS = 4;
+constexpr double BLOCK_BUDGET_NS = 1e9 * FRAME_BUFFER_SIZE / SAMPLE_RATE;
+
+static ModulationSource *create_source(const char *name)
+{
+    auto source = machine::create_modulation(name);
+    if (source == nullptr)
+        return nullptr;
+
+    for (auto &p : source->param)
+        if (p.name != nullptr && strcmp(p.name, ".") == 0)
+            p.from_float(0.65f); // attenuverter +0.3
+
+    return source;
+}
+
+int main(int argc, char **argv)
+{
+    float seconds = 2.f;
+    bool shared = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:f:1")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            seconds = atof(optarg);
+            break;
+        case 'f':
+            host::flash_dir = optarg;
+            break;
+        case '1':
+            shared = true;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s seconds] [-1] [-f flashdir] [engine-filter ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    host::init_engines();
+
+    IO io[SLOTS];
+    std::vector<Engine *> engines;
+    for (auto &entry : host::engines())
+    {
+        if (engines.size() == SLOTS || !host::matches(entry, argc - optind, &argv[optind]))
+            continue;
+
+        io[engines.size()].aux = 1;
+        if (auto engine = host::create_engine(entry, &io[engines.size()]))
+        {
+            printf("slot %zu: %s/%s\n", engines.size() + 1, entry.machine, entry.name);
+            engines.push_back(engine);
+        }
+    }
+
+    static const char *names[] = {"LFO", "ENV", "CV", "RND", "EF"};
+    std::vector<ModulationSource *> sources;
+    host::ModulationMatrix matrix;
+
+    for (auto engine : engines)
+    {
+        for (auto &p : engine->param)
+        {
+            if (p.type == Parameter::NONE || (p.flags & Parameter::IS_PRESET))
+                continue;
+
+            if (sources.empty() || !shared)
+                sources.push_back(create_source(names[sources.size() % LEN_OF(names)]));
+
+            if (sources.back() != nullptr)
+                matrix.attach(sources.back(), p);
+        }
+    }
+
+    host::Stimulus stimulus;
+    const uint32_t blocks = seconds * host::BLOCKS_PER_SECOND;
+    double engines_ns = 0;
+
+    for (uint32_t t = 0; t < blocks; t++)
+    {
+        ControlFrame frame;
+        stimulus.next(t, frame, engines[0]);
+
+        matrix.process(frame);
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (auto engine : engines)
+        {
+            OutputFrame of;
+            engine->process(frame, of);
+        }
+        engines_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    auto &cost = matrix.cost();
+    printf("routes: %zu, source evaluations per block: %u\n", matrix.size(), cost.evaluations);
+    printf("modulation: mean %.0f ns, max %.0f ns per block (%.2f%% / %.2f%% of the block budget)\n",
+           cost.mean_ns(), cost.max_ns, cost.mean_ns() / BLOCK_BUDGET_NS * 100, cost.max_ns / BLOCK_BUDGET_NS * 100);
+    printf("engines:    mean %.0f ns per block\n", blocks ? engines_ns / blocks : 0);
+
+    for (auto engine : engines)
+        host::destroy_engine(engine);
+
+    for (auto source : sources)
+        machine::mfree(source);
+
+    return 0;
+}
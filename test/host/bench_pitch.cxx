@@ -0,0 +1,122 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// Pitch conversion micro benchmark: lib/misc/pitch.hxx against powf/expf and
+// stmlib::SemitonesToRatio, max. error in cent against std::exp2 (double).
+// Inputs are V/OCT values (-4..+6 octaves), per block (FRAME_BUFFER_SIZE) and per sample.
+//
+//   bench_pitch [iterations]
+
+#include "machine.h"
+#include "stmlib/dsp/units.h"
+#include "misc/pitch.hxx"
+#include <chrono>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+constexpr int N = machine::FRAME_BUFFER_SIZE;
+
+static float sink = 0;
+
+// Best of 7 runs, the host timing is noisy. Returns ns per conversion.
+template <typename F>
+static double measure(int iterations, F fn)
+{
+    double best = 1e12;
+    for (int r = 0; r < 7; r++)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            fn(i);
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / iterations / N);
+    }
+    return best;
+}
+
+template <typename F>
+static double max_cent_error(const float *in, int size, F fn)
+{
+    double err = 0;
+    for (int i = 0; i < size; i++)
+        err = std::max(err, fabs(1200.0 * log2(fn(in[i]) / std::exp2((double)in[i]))));
+    return err;
+}
+
+int main(int argc, char **argv)
+{
+    const int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+
+    static float in[256 * N], out[N];
+    srand(1);
+    for (auto &x : in)
+        x = -4.f + 10.f * rand() / RAND_MAX;
+
+    auto block = [&](int i)
+    { return &in[(i & 255) * N]; };
+
+    struct
+    {
+        const char *name;
+        double err;
+        double ns;
+    } results[] = {
+        {"powf(2, x)", max_cent_error(in, 256 * N, [](float x)
+                                      { return powf(2.f, x); }),
+         measure(iterations, [&](int i)
+                 { auto x = block(i); for (int s = 0; s < N; s++) out[s] = powf(2.f, x[s]); sink += out[0]; })},
+        {"expf(x*ln2)", max_cent_error(in, 256 * N, [](float x)
+                                       { return expf(x * 0.69314718f); }),
+         measure(iterations, [&](int i)
+                 { auto x = block(i); for (int s = 0; s < N; s++) out[s] = expf(x[s] * 0.69314718f); sink += out[0]; })},
+        {"SemitonesToRatio", max_cent_error(in, 256 * N, [](float x)
+                                            { return stmlib::SemitonesToRatio(x * 12.f); }),
+         measure(iterations, [&](int i)
+                 { auto x = block(i); for (int s = 0; s < N; s++) out[s] = stmlib::SemitonesToRatio(x[s] * 12.f); sink += out[0]; })},
+        {"pitch::exp2", max_cent_error(in, 256 * N, [](float x)
+                                       { return pitch::exp2(x); }),
+         measure(iterations, [&](int i)
+                 { auto x = block(i); for (int s = 0; s < N; s++) out[s] = pitch::exp2(x[s]); sink += out[0]; })},
+        {"pitch::exp2 batch", max_cent_error(in, 256 * N, [](float x)
+                                             { float y; pitch::exp2(&x, &y, 1); return y; }),
+         measure(iterations, [&](int i)
+                 { pitch::exp2(block(i), out, N); sink += out[0]; })},
+    };
+
+    printf("%-20s %10s %12s\n", "", "max cent", "ns/value");
+    for (auto &r : results)
+        printf("%-20s %10.4f %12.2f\n", r.name, r.err, r.ns);
+
+    // Per block conversion (V/OCT input), pitch unchanged in 15 of 16 blocks
+    pitch::CachedExp2 cached;
+    double per_block = measure(iterations, [&](int i)
+                               { sink += powf(2.f, in[(i >> 4) & 255]); }) * N;
+    double per_block_cached = measure(iterations, [&](int i)
+                                      { sink += cached(in[(i >> 4) & 255]); }) * N;
+    printf("\nper block: powf %.2f ns, pitch::CachedExp2 %.2f ns (pitch changes every 16th block)\n", per_block, per_block_cached);
+
+    return sink == 12345.f;
+}
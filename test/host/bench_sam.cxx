@@ -0,0 +1,197 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// SAM speech rendering, worst-case block cost: SAMMain renders the whole utterance in the
+// block of the trigger, SAMPrepare + SAMRender spread it over the blocks at playback speed
+// (chunk = samples per block, 22050Hz output). Also checks that both outputs are identical.
+// The second table switches the words of the SAM engine: blocks from the switch until the word is
+// audible (retriggered every 8 blocks) - words still in its cache play at once.
+//
+//   bench_sam [chunk] [text ...]
+
+#include "host.h"
+#include <chrono>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+extern "C"
+{
+#include "SAM/sam.h"
+#include "SAM/reciter.h"
+}
+
+static uint8_t output[96000];
+static int output_len = 0;
+
+static double now_ns()
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void to_phonemes(const char *text, char *input)
+{
+    snprintf(input, 256, "%s[", text);
+    for (int i = 0; input[i] != 0; i++)
+        input[i] = toupper((int)input[i]);
+    TextToPhonemes((unsigned char *)input);
+}
+
+// Per block ns of one utterance (block 0 = trigger)
+static std::vector<double> say(const char *text, int chunk)
+{
+    std::vector<double> blocks;
+    char input[256];
+
+    output_len = 0;
+    double t0 = now_ns();
+    to_phonemes(text, input);
+    SetInput(input);
+
+    if (chunk <= 0)
+    {
+        SAMMain();
+        blocks.push_back(now_ns() - t0);
+        return blocks;
+    }
+
+    SAMPrepare();
+    bool more = true;
+    while (more)
+    {
+        more = SAMRender(chunk);
+        blocks.push_back(now_ns() - t0);
+        t0 = now_ns();
+    }
+    return blocks;
+}
+
+static void engine_switches()
+{
+    host::init_engines();
+
+    for (auto &entry : host::engines())
+    {
+        if (strcmp(entry.name, "SAM") != 0)
+            continue;
+
+        machine::IO io;
+        io.aux = 1;
+        auto engine = host::create_engine(entry, &io);
+        auto preset = host::preset_param(engine);
+        if (engine == nullptr || preset == nullptr)
+            return;
+
+        printf("\n%-40s %12s %12s\n", "SAM engine word", "audible_blk", "total_ns");
+
+        for (int selection : {1, 0, 1, 0, 2, 3, 4, 5, 0, 1, 2})
+        {
+            *preset->value.u8p = selection;
+            if (preset->value_changed)
+                preset->value_changed();
+
+            int audible = -1;
+            double ns = 0;
+            for (int t = 0; t < 1000 && audible < 0; t++)
+            {
+                machine::ControlFrame frame;
+                frame.trigger = (t % 8) == 0;
+                machine::OutputFrame of;
+
+                double t0 = now_ns();
+                engine->process(frame, of);
+                ns += now_ns() - t0;
+
+                for (int i = 0; i < machine::FRAME_BUFFER_SIZE && audible < 0; i++)
+                    if (of.out[i] != 0)
+                        audible = t;
+            }
+
+            printf("%-40s %12d %12.0f\n", preset->name, audible, ns);
+        }
+
+        host::destroy_engine(engine);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const int chunk = argc > 1 ? atoi(argv[1]) : 16;
+    std::vector<const char *> texts = {"electro", "techno", "modular", "synthesizer", "oscillator", "eurorack", "7",
+                                       "I am Sam, the software automatic mouth"};
+    if (argc > 2)
+        texts.assign(argv + 2, argv + argc);
+
+    SAM_write_buffer = [](int pos, char value)
+    {
+        if (pos < (int)sizeof(output))
+        {
+            output_len = std::max(output_len, pos + 1);
+            output[pos] = value;
+        }
+    };
+    SetSpeed(64);
+    SetMouth(128);
+    SetPitch(128);
+    SetThroat(128);
+
+    printf("%-40s %8s %8s %12s %12s %12s %6s\n", "text", "samples", "blocks", "SAMMain_ns", "trigger_ns", "worst_ns", "same");
+
+    for (auto text : texts)
+    {
+        // best of 5 runs per block, the host timing is noisy
+        std::vector<double> whole, chunked;
+        static uint8_t reference[sizeof(output)];
+        int reference_len = 0;
+        bool same = true;
+
+        for (int r = 0; r < 5; r++)
+        {
+            auto w = say(text, 0);
+            whole = r ? std::vector<double>{std::min(whole[0], w[0])} : w;
+            memcpy(reference, output, sizeof(output));
+            reference_len = output_len;
+
+            auto c = say(text, chunk);
+            if (r == 0)
+                chunked = c;
+            for (size_t i = 0; i < std::min(c.size(), chunked.size()); i++)
+                chunked[i] = std::min(chunked[i], c[i]);
+
+            // SAM keeps the timing table index of the previous utterance, compare after the first run
+            if (r > 0)
+                same &= output_len == reference_len && memcmp(output, reference, output_len) == 0;
+        }
+
+        printf("%-40s %8d %8zu %12.0f %12.0f %12.0f %6s\n", text, reference_len, chunked.size(), whole[0],
+               chunked[0], *std::max_element(chunked.begin() + 1, chunked.end()), same ? "yes" : "NO");
+    }
+
+    engine_switches();
+    return 0;
+}
@@ -0,0 +1,192 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// Voice benchmark: runs every engine with a "Voices" parameter (SampleEngine) with 1..16 voices
+// and a trigger every block, so that all voices are busy, and the polyphonic plaits engines
+// (PolyPlaitsEngine) with chords of 1..max voices.
+//
+//   bench_voices [-s seconds] [-f flashdir] [-x factor] [engine-filter ...]
+//
+// ns_per_voice is the mean block time divided by the mean number of playing voices,
+// voices_per_ms = voice blocks rendered per millisecond, voices_per_budget = voices that
+// fit into the real-time budget of one block (FRAME_BUFFER_SIZE / SAMPLE_RATE), voices_per_slot = into
+// a quarter of it (four engines per module). The factor (-x) scales the host timings to the target.
+
+#include "host.h"
+#include "base/SampleEngine.hxx"
+#include "base/PolyPlaitsEngine.hxx"
+#include <chrono>
+#include <unistd.h>
+
+using namespace machine;
+
+constexpr double BLOCK_BUDGET_NS = 1e9 * FRAME_BUFFER_SIZE / SAMPLE_RATE;
+constexpr int ENGINES_PER_MODULE = 4;
+
+static Parameter *voices_param(Engine *engine)
+{
+    for (auto &p : engine->param)
+        if (p.name && strcmp(p.name, "Voices") == 0 && p.type == Parameter::UINT8)
+            return &p;
+
+    return nullptr;
+}
+
+struct Run
+{
+    double mean_ns;
+    double mean_active;
+};
+
+static Run run_sampler(Engine *engine, SampleEngine *sampler, int n, uint32_t blocks)
+{
+    host::Stimulus stimulus;
+    ControlFrame frame;
+    std::chrono::nanoseconds elapsed(0);
+    uint64_t active = 0;
+
+    for (uint32_t t = 0; t < blocks; t++)
+    {
+        stimulus.next(t, frame, engine);
+        frame.trigger = true;
+
+        OutputFrame of;
+        auto t0 = std::chrono::steady_clock::now();
+        engine->process(frame, of);
+        elapsed += std::chrono::steady_clock::now() - t0;
+
+        if (n == 1)
+            active++;
+        else
+            for (int k = 0; k < n; k++)
+                active += sampler->voices[k].active();
+    }
+
+    return {(double)elapsed.count() / blocks, (double)active / blocks};
+}
+
+// Chord of n notes, retriggered every 1/2s
+static Run run_poly_plaits(PolyPlaitsVoices *engine, int n, uint32_t blocks)
+{
+    ControlFrame frame;
+    std::chrono::nanoseconds elapsed(0);
+    uint64_t active = 0;
+
+    for (uint32_t t = 0; t < blocks; t++)
+    {
+        frame.t = t;
+        if ((t % (host::BLOCKS_PER_SECOND / 2)) == 0)
+            for (int k = 0; k < n; k++)
+            {
+                engine->onMidiNote(DEFAULT_NOTE + k * 4, 0);
+                engine->onMidiNote(DEFAULT_NOTE + k * 4, 100);
+            }
+
+        OutputFrame of;
+        auto t0 = std::chrono::steady_clock::now();
+        engine->process(frame, of);
+        elapsed += std::chrono::steady_clock::now() - t0;
+        active += engine->rendered;
+    }
+
+    return {(double)elapsed.count() / blocks, (double)active / blocks};
+}
+
+int main(int argc, char **argv)
+{
+    float seconds = 2.f;
+    float factor = 1.f;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:f:x:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            seconds = atof(optarg);
+            break;
+        case 'f':
+            host::flash_dir = optarg;
+            break;
+        case 'x':
+            factor = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s seconds] [-f flashdir] [-x factor] [engine-filter ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    host::init_engines();
+
+    printf("engine,voices,active,mean_ns,ns_per_voice,voices_per_ms,voices_per_budget,voices_per_slot\n");
+
+    for (auto &entry : host::engines())
+    {
+        if (!host::matches(entry, argc - optind, &argv[optind]))
+            continue;
+
+        for (int n : {1, 2, 4, 6, 8, 12, 16})
+        {
+            IO io;
+            Engine *engine = host::create_engine(entry, &io);
+            if (engine == nullptr)
+                break;
+
+            const uint32_t blocks = seconds * host::BLOCKS_PER_SECOND;
+            auto param = voices_param(engine);
+            auto sampler = dynamic_cast<SampleEngine *>(engine);
+            auto poly = dynamic_cast<PolyPlaitsVoices *>(engine);
+
+            Run run;
+            if (param && sampler)
+            {
+                *param->value.u8p = n;
+                run = run_sampler(engine, sampler, n, blocks);
+            }
+            else if (poly && (poly->set_voices(n), poly->voices() == (size_t)n))
+            {
+                run = run_poly_plaits(poly, n, blocks);
+            }
+            else
+            {
+                host::destroy_engine(engine);
+                break;
+            }
+
+            run.mean_ns *= factor;
+            const double mean_active = std::max(1.0, run.mean_active);
+            const double ns_per_voice = run.mean_ns / mean_active;
+
+            printf("%s/%s,%d,%.1f,%.0f,%.0f,%.0f,%.0f,%.0f\n", entry.machine, entry.name, n, mean_active,
+                   run.mean_ns, ns_per_voice, 1e6 / ns_per_voice, BLOCK_BUDGET_NS / ns_per_voice,
+                   BLOCK_BUDGET_NS / ENGINES_PER_MODULE / ns_per_voice);
+
+            host::destroy_engine(engine);
+        }
+    }
+
+    return 0;
+}
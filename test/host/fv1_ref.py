@@ -0,0 +1,772 @@
+#!/usr/bin/env python3
+#
+# Reference output of lib/fv1/FV1.S (the Cortex-M7 FV-1 interpreter of the firmware) for the
+# programs dumped by bench_fv1, compared sample by sample with the output of lib/fv1/FV1.cc.
+#
+#   ./build/bench_fv1 -s 0.25 -d /tmp/fv1     # input, programs and FV1.cc output
+#   ./fv1_ref.py /tmp/fv1 [name ...]           # runs FV1.S on the same input, exit code 1 on mismatch
+#
+# FV1.S is executed on the assembler source: an interpreter for the Thumb-2/VFP subset that
+# gcc emitted for it (no ARM toolchain needed). malloc/memset are provided here, exp2tab is
+# read from lib/msfa/exp2.cc. Slow (1-2k samples/s), a few tenths of a second are enough.
+
+import math
+import os
+import re
+import struct
+import sys
+from fractions import Fraction
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..")
+FV1_S = os.path.join(ROOT, "lib", "fv1", "FV1.S")
+EXP2_CC = os.path.join(ROOT, "lib", "msfa", "exp2.cc")
+
+MEM_SIZE = 4 << 20
+HEAP = 1 << 20
+STACK = MEM_SIZE - 16
+RETURN = 0xFFFFFFF0
+M32 = 0xFFFFFFFF
+
+REGS = {"r%d" % i: i for i in range(16)}
+REGS.update({"sl": 10, "fp": 11, "ip": 12, "sp": 13, "lr": 14, "pc": 15})
+
+CONDS = ("eq", "ne", "cs", "hs", "cc", "lo", "mi", "pl", "vs", "vc", "hi", "ls", "ge", "lt", "gt", "le", "al")
+
+BASES = sorted(
+    """mov movw movt mvn add addw sub rsb and orr eor bic lsl lsr asr mul mla smull umull ssat ubfx sbfx
+    cmp cmn tst ldr ldrb ldrh ldrd str strb strh strd push pop cbz cbnz tbh tbb""".split(),
+    key=len,
+    reverse=True,
+)
+
+U32 = struct.Struct("<I")
+U16 = struct.Struct("<H")
+
+
+def s32(x):
+    x &= M32
+    return x - (1 << 32) if x & 0x80000000 else x
+
+
+def f32(bits):
+    return struct.unpack("<f", struct.pack("<I", bits & M32))[0]
+
+
+def f32_bits(x):
+    # round to nearest even (python floats are doubles)
+    try:
+        return struct.unpack("<I", struct.pack("<f", x))[0]
+    except OverflowError:
+        return 0x7F800000 if x > 0 else 0xFF800000
+
+
+def split_operands(s):
+    out, depth, cur = [], 0, ""
+    for ch in s:
+        if ch in "[{":
+            depth += 1
+        elif ch in "]}":
+            depth -= 1
+        if ch == "," and depth == 0:
+            out.append(cur.strip())
+            cur = ""
+        else:
+            cur += ch
+    if cur.strip():
+        out.append(cur.strip())
+    return out
+
+
+def exp2tab():
+    src = open(EXP2_CC).read()
+    body = src[src.index("exp2tab[2048]"):]
+    body = body[body.index("{") + 1:body.index("}")]
+    return [int(v, 0) for v in re.findall(r"-?0x[0-9a-fA-F]+|-?\d+", body)]
+
+
+class Program:
+    """FV1.S laid out in memory, instructions compiled to closures"""
+
+    def __init__(self, path):
+        self.mem = bytearray(MEM_SIZE)
+        self.R = [0] * 16
+        self.S = [0] * 32  # VFP single registers (bits)
+        self.F = [0, 0, 0, 0]  # N Z C V
+        self.symbols = {}
+        self.code = {}
+        self.hooks = {}
+        self.heap = HEAP
+
+        lines = []
+        for line in re.sub(r"/\*.*?\*/", "", open(path).read(), flags=re.S).splitlines():
+            line = line.split("@")[0].rstrip()
+            if line.strip():
+                lines.append(line)
+
+        # pass 1: addresses
+        addr = 0x1000
+        items = []
+        for line in lines:
+            s = line.strip()
+            m = re.match(r"^([.\w$]+):$", s)
+            if m:
+                self.symbols[m.group(1)] = addr
+                continue
+            if s.startswith("."):
+                d = s.split(None, 1)
+                arg = d[1] if len(d) > 1 else ""
+                if d[0] in (".align", ".p2align"):
+                    n = 1 << int(arg.split(",")[0])
+                    addr = (addr + n - 1) & ~(n - 1)
+                elif d[0] == ".section":
+                    addr = (addr + 15) & ~15
+                elif d[0] == ".word":
+                    items.append((addr, "word", arg))
+                    addr += 4
+                elif d[0] == ".2byte":
+                    items.append((addr, "half", arg))
+                    addr += 2
+                elif d[0] == ".space":
+                    addr += int(arg)
+                elif d[0] == ".set":
+                    name, expr = [x.strip() for x in arg.split(",", 1)]
+                    if expr.replace(" ", "") == ".+0":
+                        self.symbols[name] = addr
+                continue
+            items.append((addr, "insn", s))
+            addr += 4
+
+        # externals
+        addr = (addr + 15) & ~15
+        self.symbols["exp2tab"] = addr
+        for i, v in enumerate(exp2tab()):
+            U32.pack_into(self.mem, addr + i * 4, v & M32)
+        addr += 2048 * 4
+        for name, fn in (("malloc", self._malloc), ("memset", self._memset)):
+            self.symbols[name] = addr
+            self.hooks[addr] = fn
+            addr += 4
+        assert addr < HEAP
+
+        # pass 2: data and code
+        for a, kind, arg in items:
+            if kind == "word":
+                U32.pack_into(self.mem, a, self.eval(arg) & M32)
+            elif kind == "half":
+                U16.pack_into(self.mem, a, self.eval(arg) & 0xFFFF)
+            else:
+                self.code[a] = self.compile(a, arg)
+
+    def eval(self, expr):
+        expr = re.sub(r"[.A-Za-z_][\w.$]*", lambda m: str(self.symbols[m.group(0)]), expr)
+        return int(eval(expr.replace("/", "//")))
+
+    # memory
+
+    def ld32(self, a):
+        return U32.unpack_from(self.mem, a)[0]
+
+    def st32(self, a, v):
+        U32.pack_into(self.mem, a, v & M32)
+
+    def _malloc(self):
+        size = self.R[0]
+        self.R[0] = self.heap
+        self.heap = (self.heap + size + 15) & ~15
+        assert self.heap < STACK - 0x10000, "heap"
+
+    def _memset(self):
+        R = self.R
+        self.mem[R[0]:R[0] + R[2]] = bytes([R[1] & 0xFF]) * R[2]
+
+    # execution
+
+    def call(self, name, *args, floats=(), stack=()):
+        R = self.R
+        for i, v in enumerate(args):
+            R[i] = v & M32
+        for i, v in enumerate(floats):
+            self.S[i] = f32_bits(v)
+        R[13] = STACK - 4 * len(stack)
+        for i, v in enumerate(stack):
+            self.st32(R[13] + i * 4, v)
+        R[14] = RETURN
+        pc = self.symbols[name]
+        code, hooks = self.code, self.hooks
+        while pc != RETURN:
+            f = code.get(pc)
+            if f is None:
+                hooks[pc]()
+                pc = R[14] & ~1
+                continue
+            n = f()
+            pc = pc + 4 if n is None else n
+        return R[0]
+
+    def cond(self, c):
+        N, Z, C, V = self.F
+        return {
+            "eq": Z, "ne": not Z, "cs": C, "hs": C, "cc": not C, "lo": not C, "mi": N, "pl": not N,
+            "vs": V, "vc": not V, "hi": C and not Z, "ls": not C or Z, "ge": N == V, "lt": N != V,
+            "gt": not Z and N == V, "le": Z or N != V, "al": True,
+        }[c]
+
+    def compile(self, addr, text):
+        parts = text.split(None, 1)
+        mn, ops = parts[0], split_operands(parts[1]) if len(parts) > 1 else []
+
+        if re.match(r"^it[te]*$", mn):
+            return lambda: None  # the conditions are part of the following mnemonics
+
+        if mn.startswith("v"):
+            return self.compile_vfp(addr, mn, ops)
+
+        if mn in ("bl", "blx", "bx", "b") or (mn[0] == "b" and mn[1:] in CONDS):
+            return self.compile_branch(addr, mn, ops)
+
+        for base in BASES:
+            if mn.startswith(base):
+                rest = mn[len(base):]
+                setflags = rest.startswith("s") and rest not in CONDS
+                if setflags:
+                    rest = rest[1:]
+                cond = rest or "al"
+                if cond not in CONDS:
+                    continue
+                f = self.compile_op(addr, base, setflags, ops)
+                if cond == "al":
+                    return f
+                return lambda: f() if self.cond(cond) else None
+        raise ValueError("unsupported: " + text)
+
+    def compile_branch(self, addr, mn, ops):
+        R = self.R
+        if mn == "bx":
+            r = REGS[ops[0]]
+            return lambda: R[r] & ~1
+        if mn == "blx":
+            r = REGS[ops[0]]
+
+            def blx():
+                R[14] = addr + 4
+                return R[r] & ~1
+
+            return blx
+        target = self.symbols[ops[0]]
+        if mn == "bl":
+
+            def bl():
+                R[14] = addr + 4
+                return target
+
+            return bl
+        cond = mn[1:] or "al"
+        if cond == "al":
+            return lambda: target
+        return lambda: target if self.cond(cond) else None
+
+    def operand2(self, ops):
+        """flexible second operand -> fn returning (value, carry or None)"""
+        R = self.R
+        if ops[0].startswith("#"):
+            v = int(ops[0][1:], 0) & M32
+            return lambda: (v, None)
+        r = REGS[ops[0]]
+        if len(ops) == 1:
+            return lambda: (R[r], None)
+        sh, amount = ops[1].split()
+        return self.shifter(r, sh, amount)
+
+    def shifter(self, r, sh, amount):
+        R = self.R
+        if sh == "asl":
+            sh = "lsl"
+        if amount.startswith("#"):
+            n = int(amount[1:])
+            get_n = lambda: n
+        else:
+            rn = REGS[amount]
+            get_n = lambda: R[rn] & 0xFF
+
+        def shift():
+            v, n = R[r], get_n()
+            if n == 0:
+                return v, None
+            if sh == "lsl":
+                return (v << n) & M32 if n < 32 else 0, (v >> (32 - n)) & 1 if n <= 32 else 0
+            if sh == "lsr":
+                return v >> n if n < 32 else 0, (v >> (n - 1)) & 1 if n <= 32 else 0
+            if sh == "asr":
+                sv = s32(v)
+                n = min(n, 32)
+                return (sv >> n) & M32 if n < 32 else (M32 if sv < 0 else 0), (sv >> (n - 1)) & 1
+            raise ValueError(sh)
+
+        return shift
+
+    def address(self, op, post=None):
+        """[rn], [rn, #imm], [rn, rm], [rn, rm, lsl #n], optional ! and post-index -> (fn addr, fn writeback)"""
+        R = self.R
+        wb = op.endswith("!")
+        inner = op.rstrip("!").strip("[]")
+        parts = [x.strip() for x in inner.split(",")]
+        rn = REGS[parts[0]]
+        if len(parts) == 1:
+            off = lambda: 0
+        elif parts[1].startswith("#"):
+            k = int(parts[1][1:], 0)
+            off = lambda: k
+        else:
+            rm = REGS[parts[1]]
+            n = int(parts[2].split("#")[1]) if len(parts) > 2 else 0
+            off = lambda: R[rm] << n
+        if post is not None:
+            k = int(post[1:], 0)
+            return (lambda: R[rn]), (lambda: R.__setitem__(rn, (R[rn] + k) & M32))
+        if wb:
+            return (lambda: (R[rn] + off()) & M32), (lambda: R.__setitem__(rn, (R[rn] + off()) & M32))
+        return (lambda: (R[rn] + off()) & M32), None
+
+    def set_nz(self, v):
+        self.F[0] = (v >> 31) & 1
+        self.F[1] = int(v == 0)
+
+    def compile_op(self, addr, op, s, ops):
+        R, F, mem = self.R, self.F, self.mem
+        ld32, st32 = self.ld32, self.st32
+
+        if op in ("mov", "mvn", "movw"):
+            d = REGS[ops[0]]
+            src = self.operand2(ops[1:])
+            inv = op == "mvn"
+
+            def mov():
+                v, c = src()
+                if inv:
+                    v ^= M32
+                R[d] = v
+                if s:
+                    self.set_nz(v)
+                    if c is not None:
+                        F[2] = c
+                if d == 15:
+                    return v & ~1
+
+            return mov
+
+        if op == "movt":
+            d = REGS[ops[0]]
+            k = int(ops[1][1:], 0)
+
+            def movt():
+                R[d] = (R[d] & 0xFFFF) | (k << 16)
+
+            return movt
+
+        if op in ("add", "addw", "sub", "rsb", "cmp", "cmn"):
+            if op in ("cmp", "cmn"):
+                d, n, src, s = None, REGS[ops[0]], self.operand2(ops[1:]), True
+            else:
+                d = REGS[ops[0]]
+                if len(ops) == 2:
+                    n, src = d, self.operand2(ops[1:])
+                else:
+                    n, src = REGS[ops[1]], self.operand2(ops[2:])
+            sub = op in ("sub", "cmp")
+            rsb = op == "rsb"
+            pc_base = (addr + 4) & ~3
+
+            def arith():
+                a = pc_base if n == 15 else R[n]
+                b, _ = src()
+                if rsb:
+                    a, b = b, a
+                if sub or rsb:
+                    r = a + (b ^ M32) + 1
+                else:
+                    r = a + b
+                v = r & M32
+                if s:
+                    F[0] = v >> 31
+                    F[1] = int(v == 0)
+                    F[2] = int(r > M32)
+                    bb = (b ^ M32) if (sub or rsb) else b
+                    F[3] = int(((a ^ v) & (bb ^ v)) >> 31)
+                if d is not None:
+                    R[d] = v
+
+            return arith
+
+        if op in ("and", "orr", "eor", "bic", "tst"):
+            if op == "tst":
+                d, n, src, s = None, REGS[ops[0]], self.operand2(ops[1:]), True
+            elif len(ops) == 2:
+                d = REGS[ops[0]]
+                n, src = d, self.operand2(ops[1:])
+            else:
+                d, n, src = REGS[ops[0]], REGS[ops[1]], self.operand2(ops[2:])
+            fn = {
+                "and": lambda a, b: a & b,
+                "tst": lambda a, b: a & b,
+                "orr": lambda a, b: a | b,
+                "eor": lambda a, b: a ^ b,
+                "bic": lambda a, b: a & ~b & M32,
+            }[op]
+
+            def logic():
+                b, c = src()
+                v = fn(R[n], b)
+                if s:
+                    self.set_nz(v)
+                    if c is not None:
+                        F[2] = c
+                if d is not None:
+                    R[d] = v
+
+            return logic
+
+        if op in ("lsl", "lsr", "asr"):
+            d = REGS[ops[0]]
+            if len(ops) == 2:
+                shift = self.shifter(d, op, ops[1])
+            else:
+                shift = self.shifter(REGS[ops[1]], op, ops[2])
+
+            def sh():
+                v, c = shift()
+                R[d] = v
+                if s:
+                    self.set_nz(v)
+                    if c is not None:
+                        F[2] = c
+
+            return sh
+
+        if op == "mul":
+            d, n, m = (REGS[x] for x in ops)
+            return lambda: R.__setitem__(d, (R[n] * R[m]) & M32)
+
+        if op == "mla":
+            d, n, m, a = (REGS[x] for x in ops)
+            return lambda: R.__setitem__(d, (R[n] * R[m] + R[a]) & M32)
+
+        if op in ("smull", "umull"):
+            lo, hi, n, m = (REGS[x] for x in ops)
+            signed = op == "smull"
+
+            def mull():
+                p = s32(R[n]) * s32(R[m]) if signed else R[n] * R[m]
+                R[lo] = p & M32
+                R[hi] = (p >> 32) & M32
+
+            return mull
+
+        if op == "ssat":
+            d = REGS[ops[0]]
+            bits = int(ops[1][1:])
+            src = self.operand2(ops[2:])
+            hi, lo = (1 << (bits - 1)) - 1, -(1 << (bits - 1))
+
+            def ssat():
+                v = s32(src()[0])
+                R[d] = min(max(v, lo), hi) & M32
+
+            return ssat
+
+        if op in ("ubfx", "sbfx"):
+            d, n = REGS[ops[0]], REGS[ops[1]]
+            lsb, width = int(ops[2][1:]), int(ops[3][1:])
+            mask = (1 << width) - 1
+            signed = op == "sbfx"
+
+            def bfx():
+                v = (R[n] >> lsb) & mask
+                if signed and v >> (width - 1):
+                    v -= 1 << width
+                R[d] = v & M32
+
+            return bfx
+
+        if op in ("ldr", "ldrb", "ldrh", "str", "strb", "strh"):
+            t = REGS[ops[0]]
+            if op == "ldr" and not ops[1].startswith("["):
+                a = self.eval(ops[1])
+                return lambda: R.__setitem__(t, ld32(a))
+            ea, wb = self.address(ops[1], ops[2] if len(ops) > 2 else None)
+            size = {"": 4, "b": 1, "h": 2}[op[3:]]
+            load = op.startswith("ldr")
+
+            def ldst():
+                a = ea()
+                if load:
+                    if size == 4:
+                        v = ld32(a)
+                    elif size == 2:
+                        v = U16.unpack_from(mem, a)[0]
+                    else:
+                        v = mem[a]
+                    R[t] = v
+                else:
+                    if size == 4:
+                        st32(a, R[t])
+                    elif size == 2:
+                        U16.pack_into(mem, a, R[t] & 0xFFFF)
+                    else:
+                        mem[a] = R[t] & 0xFF
+                if wb:
+                    wb()
+                if load and t == 15:
+                    return R[15] & ~1
+
+            return ldst
+
+        if op in ("ldrd", "strd"):
+            t = REGS[ops[0]]
+            if ops[1].startswith("["):
+                t2, rest = t + 1, ops[1:]
+            else:
+                t2, rest = REGS[ops[1]], ops[2:]
+            ea, wb = self.address(rest[0], rest[1] if len(rest) > 1 else None)
+            load = op == "ldrd"
+
+            def ldstd():
+                a = ea()
+                if load:
+                    R[t], R[t2] = ld32(a), ld32(a + 4)
+                else:
+                    st32(a, R[t])
+                    st32(a + 4, R[t2])
+                if wb:
+                    wb()
+
+            return ldstd
+
+        if op in ("push", "pop"):
+            regs = sorted(REGS[x.strip()] for x in ops[0].strip("{}").split(","))
+
+            if op == "push":
+
+                def push():
+                    sp = R[13] - 4 * len(regs)
+                    for i, r in enumerate(regs):
+                        st32(sp + 4 * i, R[r])
+                    R[13] = sp
+
+                return push
+
+            def pop():
+                sp = R[13]
+                for i, r in enumerate(regs):
+                    R[r] = ld32(sp + 4 * i)
+                R[13] = sp + 4 * len(regs)
+                if 15 in regs:
+                    return R[15] & ~1
+
+            return pop
+
+        if op in ("cbz", "cbnz"):
+            n = REGS[ops[0]]
+            target = self.symbols[ops[1]]
+            zero = op == "cbz"
+            return lambda: target if (R[n] == 0) == zero else None
+
+        if op == "tbh":
+            inner = [x.strip() for x in ops[0].strip("[]").split(",")]
+            m = REGS[inner[1]]
+            table = addr + 4
+
+            def tbh():
+                return table + 2 * U16.unpack_from(mem, table + 2 * R[m])[0]
+
+            return tbh
+
+        raise ValueError("unsupported op " + op)
+
+    def compile_vfp(self, addr, mn, ops):
+        R, S, mem = self.R, self.S, self.mem
+        ld32, st32 = self.ld32, self.st32
+
+        def sreg(x):
+            return int(x[1:])
+
+        def sregs(lst):
+            out = []
+            for x in lst.strip("{}").split(","):
+                x = x.strip()
+                if x.startswith("d"):
+                    out += [2 * int(x[1:]), 2 * int(x[1:]) + 1]
+                elif "-" in x:
+                    a, b = x.split("-")
+                    out += list(range(sreg(a), sreg(b) + 1))
+                else:
+                    out.append(sreg(x))
+            return out
+
+        base = mn.split(".")[0]
+
+        if base == "vmov":
+            d, src = ops
+            if src.startswith("#"):
+                bits = f32_bits(float(src[1:]))
+                return lambda: S.__setitem__(sreg(d), bits)
+            if d.startswith("s") and src.startswith("s"):
+                a, b = sreg(d), sreg(src)
+                return lambda: S.__setitem__(a, S[b])
+            if d.startswith("s"):
+                a, r = sreg(d), REGS[src]
+                return lambda: S.__setitem__(a, R[r])
+            r, b = REGS[d], sreg(src)
+            return lambda: R.__setitem__(r, S[b])
+
+        if base in ("vldr", "vstr"):
+            d = sreg(ops[0])
+            if not ops[1].startswith("["):
+                a = self.eval(ops[1])
+                return lambda: S.__setitem__(d, ld32(a))
+            ea, _ = self.address(ops[1])
+            if base == "vldr":
+                return lambda: S.__setitem__(d, ld32(ea()))
+            return lambda: st32(ea(), S[d])
+
+        if base in ("vldmia", "vstmia", "vldm", "vpush"):
+            if base == "vpush":
+                regs = sregs(ops[0])
+
+                def vpush():
+                    sp = R[13] - 4 * len(regs)
+                    for i, r in enumerate(regs):
+                        st32(sp + 4 * i, S[r])
+                    R[13] = sp
+
+                return vpush
+            n = REGS[ops[0].rstrip("!")]
+            wb = ops[0].endswith("!")
+            regs = sregs(ops[1])
+            load = base != "vstmia"
+
+            def vldst():
+                a = R[n]
+                for i, r in enumerate(regs):
+                    if load:
+                        S[r] = ld32(a + 4 * i)
+                    else:
+                        st32(a + 4 * i, S[r])
+                if wb:
+                    R[n] = (a + 4 * len(regs)) & M32
+
+            return vldst
+
+        if mn == "vcvt.f32.s32":
+            d, m = sreg(ops[0]), sreg(ops[1])
+            return lambda: S.__setitem__(d, f32_bits(float(s32(S[m]))))
+
+        if mn == "vcvt.s32.f32":
+            d, m = sreg(ops[0]), sreg(ops[1])
+            fbits = int(ops[2][1:]) if len(ops) > 2 else 0
+
+            def cvt():
+                x = f32(S[m])
+                if x != x:
+                    v = 0
+                else:
+                    x *= 1 << fbits
+                    v = 2**31 - 1 if x >= 2**31 else (-(2**31) if x <= -(2**31) else int(x))
+                S[d] = v & M32
+
+            return cvt
+
+        if mn in ("vmul.f32", "vsub.f32", "vadd.f32"):
+            d, n, m = (sreg(x) for x in ops)
+            fn = {"vmul": lambda a, b: a * b, "vsub": lambda a, b: a - b, "vadd": lambda a, b: a + b}[base]
+            return lambda: S.__setitem__(d, f32_bits(fn(f32(S[n]), f32(S[m]))))
+
+        if mn == "vfma.f32":
+            d, n, m = (sreg(x) for x in ops)
+
+            def vfma():
+                a, b, c = f32(S[n]), f32(S[m]), f32(S[d])
+                exact = Fraction(a) * Fraction(b) + Fraction(c)
+                S[d] = f32_bits(float(exact)) if abs(exact) > 0 else f32_bits(a * b + c)
+
+            return vfma
+
+        raise ValueError("unsupported vfp " + mn)
+
+
+class FV1:
+    """fv1_init/fv1_load/fv1_set_fx/fv1_process of FV1.S"""
+
+    def __init__(self):
+        self.p = Program(FV1_S)
+        self.fv1 = self.p.call("fv1_init", 0)
+
+    def alloc(self, size):
+        a = self.p.heap
+        self.p.heap += (size + 15) & ~15
+        assert self.p.heap < STACK - 0x10000, "heap"
+        return a
+
+    def load(self, code):
+        a = self.alloc(len(code))
+        self.p.mem[a:a + len(code)] = code
+        self.p.call("fv1_load", self.fv1, a, 0)
+
+    def set_fx(self, n):
+        self.p.call("fv1_set_fx", self.fv1, n)
+
+    def process(self, inL, inR, pots, block):
+        p, n = self.p, len(inL)
+        a_inL, a_inR, a_outL, a_outR = (self.alloc(4 * n) for _ in range(4))
+        struct.pack_into("<%df" % n, p.mem, a_inL, *inL)
+        struct.pack_into("<%df" % n, p.mem, a_inR, *inR)
+        for i in range(0, n, block):
+            k = min(block, n - i)
+            p.call("fv1_process", self.fv1, a_inL + 4 * i, a_inR + 4 * i, a_outL + 4 * i,
+                   floats=pots, stack=(a_outR + 4 * i, k))
+        return (list(struct.unpack_from("<%df" % n, p.mem, a_outL)),
+                list(struct.unpack_from("<%df" % n, p.mem, a_outR)))
+
+
+def main(argv):
+    if not argv:
+        print("fv1_ref.py dir [name ...]")
+        return 2
+
+    path, names = argv[0], argv[1:]
+    manifest = [line.strip().split(None, 2) for line in open(os.path.join(path, "manifest.txt")) if line.strip()]
+    header = manifest.pop(0)  # block size, pot0,pot1,pot2
+    block, pots = int(header[0]), tuple(float(x) for x in header[1].split(","))
+
+    raw = open(os.path.join(path, "input.raw"), "rb").read()
+    inp = list(struct.unpack("<%df" % (len(raw) // 4), raw))
+
+    errors = 0
+    print("program,samples,max_diff,first_mismatch")
+    for out_file, prog, name in manifest:
+        if names and name not in names:
+            continue
+        fv1 = FV1()
+        if prog.startswith("fx:"):
+            fv1.set_fx(int(prog[3:]))
+        else:
+            fv1.load(open(os.path.join(path, prog), "rb").read())
+
+        outL, outR = fv1.process(inp, inp, pots, block)
+
+        raw = open(os.path.join(path, out_file), "rb").read()
+        host = struct.unpack("<%df" % (len(raw) // 4), raw)
+        first, diff = -1, 0.0
+        for i in range(len(inp)):
+            for a, b in ((outL[i], host[2 * i]), (outR[i], host[2 * i + 1])):
+                if a != b and not (a != a and b != b):
+                    diff = max(diff, abs(a - b)) if a == a and b == b else math.inf
+                    if first < 0:
+                        first = i
+        print("%s,%d,%g,%d" % (name, len(inp), diff, first), flush=True)
+        errors += first >= 0
+
+    return 1 if errors else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,203 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// Heap report: declared memory_footprint() vs. measured heap of every engine (after init and peak
+// while running with preset changes), and a check whether a 4-slot configuration fits the heap.
+//
+//   heap_report [-s seconds] [-f flashdir] [-b budget_kb] [-c slot1,slot2,slot3,slot4] [engine-filter ...]
+//
+// Slots are engine names (or MACHINE/name). An engine that does not fit gets alternatives
+// of the same machine that would fit into the remaining heap.
+
+#include "host.h"
+#include <unistd.h>
+#include <string>
+
+using namespace machine;
+
+constexpr int SLOTS = 4;
+
+static std::string full_name(const host::EngineEntry &e)
+{
+    return std::string(e.machine) + "/" + e.name;
+}
+
+static const host::EngineEntry *find_engine(const std::string &name)
+{
+    for (auto &e : host::engines())
+        if (name == e.name || name == full_name(e))
+            return &e;
+
+    return nullptr;
+}
+
+// Runs the engine with the default stimulus, steps through its presets and calls display() (UI loop)
+static void exercise(Engine *engine, uint32_t blocks)
+{
+    host::Stimulus stimulus;
+    ControlFrame frame;
+    Parameter *preset = host::preset_param(engine);
+
+    for (uint32_t t = 0; t < blocks; t++)
+    {
+        if (preset && (t % (host::BLOCKS_PER_SECOND / 4)) == 0)
+        {
+            *preset->value.u8p = preset->min + (t / (host::BLOCKS_PER_SECOND / 4)) % ((int)(preset->max - preset->min) + 1);
+            if (preset->value_changed)
+                preset->value_changed();
+        }
+
+        stimulus.next(t, frame, engine);
+        OutputFrame of;
+        engine->process(frame, of);
+
+        if ((t % 16) == 0)
+            engine->display();
+    }
+}
+
+static int plan(const std::string &config, size_t budget)
+{
+    std::vector<const host::EngineEntry *> slots;
+    size_t pos = 0;
+    while (pos <= config.size() && slots.size() < SLOTS)
+    {
+        size_t end = config.find(',', pos);
+        std::string name = config.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        auto e = find_engine(name);
+        if (e == nullptr)
+        {
+            fprintf(stderr, "unknown engine: %s\n", name.c_str());
+            return 1;
+        }
+
+        slots.push_back(e);
+        if (end == std::string::npos)
+            break;
+        pos = end + 1;
+    }
+
+    size_t total = 0;
+    for (auto e : slots)
+        total += e->footprint;
+
+    for (size_t i = 0; i < slots.size(); i++)
+        printf("slot %zu  %-28s %8zu\n", i + 1, full_name(*slots[i]).c_str(), slots[i]->footprint);
+
+    printf("total   %-28s %8zu / %zu %s\n", "", total, budget, total <= budget ? "OK" : "DOES NOT FIT");
+
+    if (total <= budget)
+        return 0;
+
+    for (size_t i = 0; i < slots.size(); i++)
+    {
+        size_t available = budget - std::min(budget, total - slots[i]->footprint);
+        auto alt = host::alternatives(*slots[i], available);
+        if (alt.empty())
+            continue;
+
+        printf("slot %zu: ", i + 1);
+        for (size_t k = 0; k < alt.size() && k < 4; k++)
+            printf("%s%s (%zu)", k ? ", " : "", alt[k]->name, alt[k]->footprint);
+        printf("\n");
+    }
+
+    return 1;
+}
+
+int main(int argc, char **argv)
+{
+    float seconds = 2.f;
+    size_t budget = 512 * 1024;
+    std::string config;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:f:b:c:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            seconds = atof(optarg);
+            break;
+        case 'f':
+            host::flash_dir = optarg;
+            break;
+        case 'b':
+            budget = atoi(optarg) * 1024;
+            break;
+        case 'c':
+            config = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s seconds] [-f flashdir] [-b budget_kb] [-c slot1,slot2,slot3,slot4] [engine-filter ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    host::init_engines();
+
+    if (!config.empty())
+        return plan(config, budget);
+
+    int undeclared = 0;
+    printf("machine,engine,declared,init,peak,status\n");
+
+    for (auto &entry : host::engines())
+    {
+        if (!host::matches(entry, argc - optind, &argv[optind]))
+            continue;
+
+        const size_t base = host::heap_used();
+        host::reset_heap_peak();
+
+        IO io;
+        Engine *engine = host::create_engine(entry, &io);
+        if (engine == nullptr)
+        {
+            printf("\"%s\",\"%s\",%zu,,,SKIPPED\n", entry.machine, entry.name, entry.footprint);
+            continue;
+        }
+
+        const size_t init = host::heap_used() - base;
+        exercise(engine, seconds * host::BLOCKS_PER_SECOND);
+        const size_t peak = host::heap_peak() - base;
+
+        host::destroy_engine(engine);
+
+        const char *status = "OK";
+        if (host::heap_used() != base)
+            status = "LEAK";
+        else if (peak > entry.footprint)
+            status = "UNDECLARED";
+
+        undeclared += strcmp(status, "OK") != 0;
+        printf("\"%s\",\"%s\",%zu,%zu,%zu,%s\n", entry.machine, entry.name, entry.footprint, init, peak, status);
+    }
+
+    if (undeclared)
+        fprintf(stderr, "%d engine(s) use more heap than declared (or leak)\n", undeclared);
+
+    return undeclared ? 1 : 0;
+}
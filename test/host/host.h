@@ -0,0 +1,257 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#pragma once
+
+#include "machine.h"
+#include "arena.h"
+#include <vector>
+#include <string>
+
+namespace host
+{
+    constexpr uint32_t BLOCKS_PER_SECOND = machine::SAMPLE_RATE / machine::FRAME_BUFFER_SIZE;
+
+    struct EngineEntry
+    {
+        const char *machine;
+        const char *name;
+        std::function<machine::Engine *()> create;
+        size_t footprint; // declared heap, see host::memory_footprint
+    };
+
+    // All engines registered by init_engines() in registration order
+    const std::vector<EngineEntry> &engines();
+
+    // Calls the init_* functions of src/*.cxx (same order as init_engines2 in main.cxx)
+    void init_engines();
+
+    // Simulated inputs, read by machine::get_aux/get_cv/get_trigger/get_gate
+    extern float aux_input[2][machine::FRAME_BUFFER_SIZE];
+    extern float cv_input[4];
+    extern uint32_t trigger_input; // bitmask
+    extern uint32_t gate_input;    // bitmask
+    extern uint32_t bpm;           // bpm * 100
+
+    // Directory with the flash blobs (707_IC34, 909_HIGH, ...) - see machine::flash_read
+    extern std::string flash_dir;
+
+    // Number of currently allocated bytes via machine::malloc
+    size_t heap_used();
+
+    // Highest heap_used() since the last reset
+    size_t heap_peak();
+    void reset_heap_peak();
+
+    // With a budget (e.g. 512K for the T4) machine::malloc serves from a first-fit heap of that size,
+    // 0 = unlimited host heap. Only call while nothing is allocated.
+    void set_heap_budget(size_t budget);
+    size_t heap_budget();
+
+    // The modeled heap (nullptr without budget), e.g. for free_bytes()/fragmentation()
+    const Arena *heap();
+
+    // Number of machine::malloc calls that returned nullptr
+    size_t heap_failures();
+
+    // Engines of the same machine that fit into available bytes, largest first
+    std::vector<const EngineEntry *> alternatives(const EngineEntry &entry, size_t available);
+
+    // Creates the engine of the entry like the firmware does (io + init()).
+    // Refuses (nullptr) if the declared footprint does not fit into the heap budget.
+    machine::Engine *create_engine(const EngineEntry &entry, machine::IO *io);
+    void destroy_engine(machine::Engine *engine);
+
+    // Engine slot with its own arena of the declared footprint. The engine and everything it allocates
+    // live in one region of the heap, released as a whole on engine change - engine swaps can only
+    // fragment the heap at slot granularity.
+    class Slot
+    {
+    public:
+        // Headers/alignment of the engine allocations on top of the footprint
+        static constexpr size_t ARENA_RESERVE = 32 * (Arena::HEADER + Arena::ALIGN);
+
+        ~Slot()
+        {
+            unload();
+        }
+
+        // Unloads the current engine; nullptr if the arena does not fit into the heap or init() fails
+        machine::Engine *load(const EngineEntry &entry, machine::IO *io);
+        void unload();
+
+        machine::Engine *engine() const
+        {
+            return _engine;
+        }
+
+        const Arena &arena() const
+        {
+            return _arena;
+        }
+
+        // Packs the arenas of the loaded slots at the bottom of the heap: the engines are recreated and
+        // get their parameter values back. Fallback if a load fails although enough heap is free in total.
+        static void compact(Slot *slots, size_t n);
+
+        // machine::malloc of the running engine (process/display) goes to the slot arena
+        struct Scope
+        {
+            Arena *prev;
+            Scope(Slot &slot);
+            ~Scope();
+        };
+
+    private:
+        Arena _arena;
+        void *_mem = nullptr;
+        machine::Engine *_engine = nullptr;
+        const EngineEntry *_entry = nullptr;
+        machine::IO *_io = nullptr;
+    };
+
+    // Modulation of the loaded slots in one pass per block, before the engines run. Each attached source
+    // is evaluated once per block, even if it modulates several parameters (a shared LFO must not
+    // advance twice). The values (Volt, what ModulationSource::process passes to Parameter::modulate)
+    // go into a contiguous array and are applied on top of the parameter values at attach time.
+    class ModulationMatrix
+    {
+    public:
+        static constexpr size_t MAX_ROUTES = 4 * LEN_OF(machine::Engine::param); // slots x parameters
+
+        // Modulation cost, see process()
+        struct Cost
+        {
+            double last_ns = 0;
+            double sum_ns = 0;
+            double max_ns = 0;
+            uint32_t blocks = 0;
+            uint32_t evaluations = 0; // source evaluations in the last block
+
+            double mean_ns() const
+            {
+                return blocks ? sum_ns / blocks : 0;
+            }
+        };
+
+        // false if the matrix is full
+        bool attach(machine::ModulationSource *source, machine::Parameter &target);
+        void detach(machine::Engine *engine);
+        void clear();
+
+        // Evaluates the sources and applies the values to the base values (the current target
+        // values if they were changed since the last call), modulations of one target add up
+        void process(machine::ControlFrame &frame);
+
+        const float *values() const
+        {
+            return _values;
+        }
+
+        size_t size() const
+        {
+            return _size;
+        }
+
+        const Cost &cost() const
+        {
+            return _cost;
+        }
+
+        void reset_cost()
+        {
+            _cost = {};
+        }
+
+    private:
+        struct Route
+        {
+            machine::ModulationSource *source;
+            machine::Parameter *target;
+            float base;    // unmodulated value
+            float applied; // value after the last process()
+        };
+
+        Route _routes[MAX_ROUTES]; // routes of a source are adjacent
+        float _values[MAX_ROUTES];
+        size_t _size = 0;
+        Cost _cost;
+    };
+
+    // Engine filter of the command line tools (substring of machine or engine name)
+    bool matches(const EngineEntry &entry, int argc, char **argv);
+
+    // Returns the preset/selection parameter of the engine (init_presets) or nullptr
+    machine::Parameter *preset_param(machine::Engine *engine);
+
+    bool write_wav(const char *path, const std::vector<float> &left, const std::vector<float> &right);
+
+    // Default test signal: triggers/gates at 120bpm, MIDI notes for MIDI engines and
+    // a decaying noise burst on the aux inputs (FX, EnvFollower) and CV1
+    struct Stimulus
+    {
+        uint32_t trig_interval = BLOCKS_PER_SECOND / 2;
+        uint32_t gate_len = BLOCKS_PER_SECOND / 10;
+        uint32_t noise = 1;
+        float burst = 0;
+
+        // Fills the control frame and the simulated inputs for block t
+        void next(uint32_t t, machine::ControlFrame &frame, machine::Engine *engine)
+        {
+            frame.t = t;
+            frame.trigger = (t % trig_interval) == 0;
+            frame.gate = (t % trig_interval) < gate_len;
+            frame.accent = (t % (trig_interval * 4)) == 0;
+            frame.clock = (t % (trig_interval / 24)) == 0 ? 1 + (t / (trig_interval / 24)) % 24 : 0;
+
+            trigger_input = frame.trigger ? 0xF : 0;
+            gate_input = frame.gate ? 0xF : 0;
+
+            if (frame.trigger)
+                burst = 0.8f;
+
+            for (int i = 0; i < machine::FRAME_BUFFER_SIZE; i++)
+            {
+                noise = noise * 1664525L + 1013904223L;
+                float n = (float)(int32_t)noise / INT32_MAX;
+                aux_input[0][i] = n * burst;
+                aux_input[1][i] = -n * burst;
+                burst *= 0.9995f;
+            }
+
+            cv_input[0] = aux_input[0][0] * 5.f;
+
+            if (engine->props & machine::MIDI_ENGINE)
+            {
+                auto midi = static_cast<machine::MidiEngine *>(engine);
+                uint8_t key = machine::DEFAULT_NOTE + (t / trig_interval) % 12;
+                if (frame.trigger)
+                    midi->onMidiNote(key, 100);
+                else if ((t % trig_interval) == gate_len)
+                    midi->onMidiNote(key, 0);
+            }
+        }
+    };
+} // namespace host
@@ -0,0 +1,687 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+#include "host.h"
+#include "plaits/resources.h"
+#include "base/SampleEngine.hxx"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <map>
+#include <chrono>
+#include <algorithm>
+
+namespace host
+{
+    float aux_input[2][machine::FRAME_BUFFER_SIZE] = {};
+    float cv_input[4] = {};
+    uint32_t trigger_input = 0;
+    uint32_t gate_input = 0;
+    uint32_t bpm = 120 * 100;
+    std::string flash_dir = "flash";
+
+    static std::vector<EngineEntry> _engines;
+    struct ModulationEntry
+    {
+        const char *name;
+        std::function<machine::ModulationSource *()> create;
+        size_t footprint;
+    };
+
+    static std::vector<ModulationEntry> _modulations;
+    static size_t _heap_used = 0;
+    static size_t _heap_peak = 0;
+    static size_t _heap_budget = 0;
+    static size_t _heap_failures = 0;
+    static std::vector<uint8_t> _heap_mem;
+    static Arena _heap;                 // T4 heap model (with budget)
+    static std::vector<Arena *> _arenas; // slot arenas, inside _heap
+    static Arena *_current_arena = nullptr; // machine::malloc target (Slot::Scope)
+
+    const std::vector<EngineEntry> &engines()
+    {
+        return _engines;
+    }
+
+    // Engines of src/voltage.cxx that create a modulation source in their constructor
+    static const struct
+    {
+        const char *machine;
+        const char *name;
+        const char *modulation;
+    } _engine_modulations[] = {
+        {machine::CV, "EnvGen_AD", "ENV"},
+        {machine::CV, "LFO", "LFO"},
+        {machine::CV, "EnvFollower", "EF"},
+    };
+
+    void declare_engine_footprint(size_t footprint)
+    {
+        auto &entry = _engines.back();
+        entry.footprint = footprint;
+
+        for (auto &it : _engine_modulations)
+            if (strcmp(it.machine, entry.machine) == 0 && strcmp(it.name, entry.name) == 0)
+                for (auto &m : _modulations)
+                    if (strcmp(m.name, it.modulation) == 0)
+                        entry.footprint += m.footprint;
+    }
+
+    void declare_modulation_footprint(size_t footprint)
+    {
+        _modulations.back().footprint = footprint;
+    }
+
+    size_t heap_used()
+    {
+        return _heap_used;
+    }
+
+    size_t heap_peak()
+    {
+        return _heap_peak;
+    }
+
+    void reset_heap_peak()
+    {
+        _heap_peak = _heap_used;
+    }
+
+    void set_heap_budget(size_t budget)
+    {
+        _heap_budget = budget;
+        _heap_mem.assign(budget, 0);
+        _heap.init(_heap_mem.data(), budget);
+    }
+
+    size_t heap_budget()
+    {
+        return _heap_budget;
+    }
+
+    const Arena *heap()
+    {
+        return _heap_budget ? &_heap : nullptr;
+    }
+
+    size_t heap_failures()
+    {
+        return _heap_failures;
+    }
+
+    // Allocation without heap accounting (slot arenas). Large arenas are placed at the top of the heap,
+    // small ones at the bottom - less holes between them than with first fit only (see stress_slots).
+    static void *heap_alloc(size_t size)
+    {
+        if (_heap_budget == 0)
+            return ::calloc(1, size);
+
+        return _heap.alloc(size, size > 32 * 1024 ? Arena::LAST_FIT : Arena::FIRST_FIT);
+    }
+
+    static void heap_free(void *p)
+    {
+        if (_heap.contains(p))
+            _heap.free(p);
+        else
+            ::free(p);
+    }
+
+    std::vector<const EngineEntry *> alternatives(const EngineEntry &entry, size_t available)
+    {
+        std::vector<const EngineEntry *> result;
+        for (auto &e : _engines)
+            if (&e != &entry && strcmp(e.machine, entry.machine) == 0 && e.footprint <= available)
+                result.push_back(&e);
+
+        std::stable_sort(result.begin(), result.end(), [](const EngineEntry *a, const EngineEntry *b)
+                         { return a->footprint > b->footprint; });
+        return result;
+    }
+
+    machine::Engine *create_engine(const EngineEntry &entry, machine::IO *io)
+    {
+        if (_heap_budget && _heap_used + entry.footprint > _heap_budget)
+        {
+            size_t available = _heap_budget > _heap_used ? _heap_budget - _heap_used : 0;
+            machine::message("%s/%s needs %zu bytes, %zu available", entry.machine, entry.name, entry.footprint, available);
+            for (auto *e : alternatives(entry, available))
+                machine::message("  try %s/%s (%zu bytes)", e->machine, e->name, e->footprint);
+            return nullptr;
+        }
+
+        machine::Engine *engine = entry.create();
+        if (engine == nullptr)
+            return nullptr;
+
+        engine->io = io;
+        if (!engine->init())
+        {
+            destroy_engine(engine);
+            return nullptr;
+        }
+
+        return engine;
+    }
+
+    void destroy_engine(machine::Engine *engine)
+    {
+        if (engine)
+        {
+            engine->~Engine();
+            machine::mfree(engine);
+        }
+    }
+
+    machine::Engine *Slot::load(const EngineEntry &entry, machine::IO *io)
+    {
+        unload();
+
+        const size_t size = entry.footprint + ARENA_RESERVE;
+        _mem = heap_alloc(size);
+        if (_mem == nullptr)
+        {
+            _heap_failures++;
+            return nullptr;
+        }
+
+        _arena.init(_mem, size);
+        _arenas.push_back(&_arena);
+
+        Scope scope(*this);
+        _engine = create_engine(entry, io);
+        if (_engine == nullptr)
+            unload();
+
+        _entry = &entry;
+        _io = io;
+        return _engine;
+    }
+
+    void Slot::compact(Slot *slots, size_t n)
+    {
+        struct Saved
+        {
+            const EngineEntry *entry;
+            machine::IO *io;
+            float values[LEN_OF(machine::Engine::param)];
+        };
+
+        std::vector<Saved> saved(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            saved[i] = {slots[i]._engine ? slots[i]._entry : nullptr, slots[i]._io, {}};
+            if (auto engine = slots[i]._engine)
+                for (size_t k = 0; k < LEN_OF(engine->param); k++)
+                    saved[i].values[k] = engine->param[k].to_float();
+
+            slots[i].unload();
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (saved[i].entry == nullptr)
+                continue;
+
+            if (auto engine = slots[i].load(*saved[i].entry, saved[i].io))
+            {
+                Scope scope(slots[i]);
+                for (size_t k = 0; k < LEN_OF(engine->param); k++)
+                    engine->param[k].from_float(saved[i].values[k]);
+            }
+        }
+    }
+
+    void Slot::unload()
+    {
+        if (_mem == nullptr)
+            return;
+
+        {
+            Scope scope(*this);
+            destroy_engine(_engine);
+            _engine = nullptr;
+        }
+
+        // Blocks the engine did not free are released with the arena
+        _heap_used -= _arena.used();
+        _arena.reset();
+        _arenas.erase(std::find(_arenas.begin(), _arenas.end(), &_arena));
+        heap_free(_mem);
+        _mem = nullptr;
+    }
+
+    Slot::Scope::Scope(Slot &slot) : prev(_current_arena)
+    {
+        _current_arena = &slot._arena;
+    }
+
+    Slot::Scope::~Scope()
+    {
+        _current_arena = prev;
+    }
+
+    static float raw_value(const machine::Parameter &p)
+    {
+        switch (p.type)
+        {
+        case machine::Parameter::FLOAT:
+            return *p.value.fp;
+        case machine::Parameter::UINT8:
+            return *p.value.u8p;
+        case machine::Parameter::UINT16:
+            return *p.value.u16p;
+        default:
+            return 0;
+        }
+    }
+
+    static void set_raw_value(machine::Parameter &p, float v)
+    {
+        switch (p.type)
+        {
+        case machine::Parameter::FLOAT:
+            *p.value.fp = v;
+            break;
+        case machine::Parameter::UINT8:
+            *p.value.u8p = v;
+            break;
+        case machine::Parameter::UINT16:
+            *p.value.u16p = v;
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool ModulationMatrix::attach(machine::ModulationSource *source, machine::Parameter &target)
+    {
+        if (_size == MAX_ROUTES || target.type == machine::Parameter::NONE)
+            return false;
+
+        // behind the other routes of the source
+        size_t i = _size;
+        for (size_t k = 0; k < _size; k++)
+            if (_routes[k].source == source)
+                i = k + 1;
+
+        std::copy_backward(&_routes[i], &_routes[_size], &_routes[_size + 1]);
+        _routes[i] = {source, &target, raw_value(target), raw_value(target)};
+        _size++;
+        return true;
+    }
+
+    void ModulationMatrix::detach(machine::Engine *engine)
+    {
+        auto end = std::remove_if(&_routes[0], &_routes[_size], [&](const Route &r)
+                                  { return r.target >= &engine->param[0] && r.target < &engine->param[LEN_OF(engine->param)]; });
+        _size = end - &_routes[0];
+    }
+
+    void ModulationMatrix::clear()
+    {
+        _size = 0;
+    }
+
+    void ModulationMatrix::process(machine::ControlFrame &frame)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+
+        // Evaluation: a probe parameter spanning -10..+10V takes the modulation of the source
+        float v = 0;
+        machine::Parameter probe;
+        probe.init(".", &v, 0, -10.f, 10.f);
+
+        machine::ModulationSource *prev = nullptr;
+        uint32_t evaluations = 0;
+
+        for (size_t i = 0; i < _size; i++)
+        {
+            auto &r = _routes[i];
+
+            // once per source, the V/OCT scaling (CV) follows the first target of the source
+            if (r.source != prev)
+            {
+                v = 0;
+                probe.flags = r.target->flags & machine::Parameter::IS_V_OCT;
+                r.source->process(probe, frame);
+                prev = r.source;
+                evaluations++;
+            }
+
+            _values[i] = v;
+        }
+
+        // Application: base value + modulation. A target that no longer holds the value applied in the
+        // last block was changed in between (knob, preset) - that value is the new base.
+        for (size_t i = 0; i < _size; i++)
+        {
+            auto &r = _routes[i];
+            const float live = raw_value(*r.target);
+            if (live != r.applied)
+                r.base = live;
+
+            set_raw_value(*r.target, r.base);
+        }
+
+        for (size_t i = 0; i < _size; i++)
+            _routes[i].target->modulate(_values[i]);
+
+        for (size_t i = 0; i < _size; i++)
+            _routes[i].applied = raw_value(*_routes[i].target);
+
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+        _cost.last_ns = ns;
+        _cost.sum_ns += ns;
+        _cost.max_ns = std::max(_cost.max_ns, ns);
+        _cost.blocks++;
+        _cost.evaluations = evaluations;
+    }
+
+    bool matches(const EngineEntry &entry, int argc, char **argv)
+    {
+        if (argc == 0)
+            return true;
+
+        for (int i = 0; i < argc; i++)
+            if (strstr(entry.name, argv[i]) || strstr(entry.machine, argv[i]))
+                return true;
+
+        return false;
+    }
+
+    machine::Parameter *preset_param(machine::Engine *engine)
+    {
+        for (auto &p : engine->param)
+            if (p.flags & machine::Parameter::IS_PRESET)
+                return &p;
+
+        return nullptr;
+    }
+
+    static void write_u32(FILE *f, uint32_t v) { fwrite(&v, sizeof(v), 1, f); }
+    static void write_u16(FILE *f, uint16_t v) { fwrite(&v, sizeof(v), 1, f); }
+
+    bool write_wav(const char *path, const std::vector<float> &left, const std::vector<float> &right)
+    {
+        FILE *f = fopen(path, "wb");
+        if (f == nullptr)
+            return false;
+
+        const uint32_t frames = std::min(left.size(), right.size());
+        const uint32_t data_size = frames * 2 * sizeof(float);
+
+        fwrite("RIFF", 1, 4, f);
+        write_u32(f, 36 + data_size);
+        fwrite("WAVEfmt ", 1, 8, f);
+        write_u32(f, 16);
+        write_u16(f, 3); // IEEE float
+        write_u16(f, 2);
+        write_u32(f, machine::SAMPLE_RATE);
+        write_u32(f, machine::SAMPLE_RATE * 2 * sizeof(float));
+        write_u16(f, 2 * sizeof(float));
+        write_u16(f, 32);
+        fwrite("data", 1, 4, f);
+        write_u32(f, data_size);
+
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            fwrite(&left[i], sizeof(float), 1, f);
+            fwrite(&right[i], sizeof(float), 1, f);
+        }
+
+        fclose(f);
+        return true;
+    }
+} // namespace host
+
+namespace machine
+{
+    // Size header in front of each block for heap accounting
+    constexpr size_t HEAP_HEADER = 16;
+
+    // Engines rely on zero initialized memory (e.g. braids::Envelope::segment_)
+    void *malloc(size_t size)
+    {
+        void *ptr = nullptr;
+        if (host::_current_arena)
+            ptr = host::_current_arena->alloc(size);
+        else if (host::_heap_budget)
+            ptr = host::_heap.alloc(size);
+        else if (uint8_t *p = (uint8_t *)::calloc(1, size + HEAP_HEADER))
+        {
+            *(size_t *)p = size;
+            ptr = p + HEAP_HEADER;
+        }
+
+        if (ptr == nullptr)
+        {
+            host::_heap_failures++;
+            return nullptr;
+        }
+
+        host::_heap_used += size;
+        host::_heap_peak = std::max(host::_heap_peak, host::_heap_used);
+        return ptr;
+    }
+
+    void mfree(void *ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        for (auto arena : host::_arenas)
+        {
+            if (arena->contains(ptr))
+            {
+                host::_heap_used -= arena->size_of(ptr);
+                arena->free(ptr);
+                return;
+            }
+        }
+
+        if (host::_heap.contains(ptr))
+        {
+            host::_heap_used -= host::_heap.size_of(ptr);
+            host::_heap.free(ptr);
+            return;
+        }
+
+        uint8_t *p = (uint8_t *)ptr - HEAP_HEADER;
+        host::_heap_used -= *(size_t *)p;
+        ::free(p);
+    }
+
+    const uint8_t *flash_read(const char *blob_name)
+    {
+        static std::map<std::string, std::vector<uint8_t>> cache;
+
+        std::string name(blob_name, strnlen(blob_name, 8));
+        auto it = cache.find(name);
+        if (it == cache.end())
+        {
+            std::vector<uint8_t> data;
+            std::string path = host::flash_dir + "/" + name;
+            if (FILE *f = fopen(path.c_str(), "rb"))
+            {
+                uint8_t tmp[4096];
+                size_t n;
+                while ((n = fread(tmp, 1, sizeof(tmp), f)) > 0)
+                    data.insert(data.end(), tmp, tmp + n);
+                fclose(f);
+            }
+            it = cache.emplace(name, std::move(data)).first;
+        }
+
+        return it->second.empty() ? nullptr : it->second.data();
+    }
+
+    void register_symbol(const char *name, void *ptr)
+    {
+    }
+
+    void message(const char *fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        vfprintf(stderr, fmt, args);
+        fputc('\n', stderr);
+        va_end(args);
+    }
+
+    uint32_t get_bpm()
+    {
+        return host::bpm;
+    }
+
+    float *get_aux(int channel)
+    {
+        return host::aux_input[channel & 1];
+    }
+
+    void get_audio(int channel, float *buffer, float gain)
+    {
+        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+            buffer[i] += host::aux_input[channel & 1][i] * gain;
+    }
+
+    float get_cv(int channel)
+    {
+        return host::cv_input[channel & 3];
+    }
+
+    bool get_trigger(int channel)
+    {
+        return host::trigger_input & (1 << channel);
+    }
+
+    bool get_gate(int channel)
+    {
+        return host::gate_input & (1 << channel);
+    }
+
+    int get_io_info(int type, int index, char *name)
+    {
+        static const char *trig_names[] = {"TR1", "TR2", "TR3", "TR4"};
+        static const char *cv_names[] = {"CV1", "CV2", "CV3", "CV4"};
+
+        if (index >= 0 && index < 4 && name != nullptr)
+            sprintf(name, "%s", type == 0 ? trig_names[index] : cv_names[index]);
+
+        return 4;
+    }
+
+    void dmod_init_reception(const char *blob_name, size_t size)
+    {
+    }
+
+    bool dmod_process(const int16_t *samples, size_t &received)
+    {
+        return false;
+    }
+
+    void add(const uint8_t *bin, size_t len)
+    {
+    }
+
+    void add_quantizer_scale(const char *name, const QuantizerScale &scale)
+    {
+    }
+
+    void add_engine(const char *machine, const char *name, std::function<Engine *()> create)
+    {
+        host::_engines.push_back({machine, name, create, 0});
+    }
+
+    void add_modulation_source(const char *name, std::function<ModulationSource *()> create)
+    {
+        host::_modulations.push_back({name, create, 0});
+    }
+
+    ModulationSource *create_modulation(const char *name)
+    {
+        for (auto &it : host::_modulations)
+            if (strcmp(it.name, name) == 0)
+                return it.create();
+
+        return nullptr;
+    }
+} // namespace machine
+
+// 8-bit unsigned ROM samples, addr_shift selects interleaved samples (TR707)
+template <>
+float tsample_spec<uint8_t>::get_float(int index) const
+{
+    if (index < 0 || index >= this->len)
+        return 0;
+
+    return ((float)reinterpret_cast<const uint8_t *>(this->data)[index << this->addr_shift] - 128) / 128;
+}
+
+namespace gfx
+{
+    static uint8_t _display_buffer[1024];
+    uint8_t *display_buffer = _display_buffer;
+
+    void drawEngine(machine::Engine *engine, const char *msg) {}
+    void drawEngineCompact(machine::Engine *engine) {}
+    void DrawKnob(int x, int y, const char *name, uint16_t value, bool selected) {}
+    void drawString(int x, int y, const char *s, int font) {}
+    void drawLine(int x1, int y1, int x2, int y2) {}
+    void drawRect(int x, int y, int w, int h) {}
+    void fillRect(int x, int y, int w, int h) {}
+    void drawCircle(int x, int y, int r) {}
+    void drawXbm(int x, int y, int w, int h, const uint8_t *xbm) {}
+    void setPixel(int x, int y) {}
+} // namespace gfx
+
+static void init_engines2()
+{
+#undef MACHINE_INIT
+#define MACHINE_INIT(init_fun)             \
+    void init_fun() __attribute__((weak)); \
+    if (init_fun)                          \
+        init_fun();
+
+    static uintptr_t p[5];
+    p[0] = (uintptr_t)plaits::fm_patches_table[0];
+    p[1] = (uintptr_t)plaits::fm_patches_table[1];
+    p[2] = (uintptr_t)plaits::fm_patches_table[2];
+    p[3] = (uintptr_t)machine::flash_read("DXFMSYX0");
+    p[4] = 0;
+
+    machine::register_symbol("fm_patches_table", p);
+
+    // the MACHINE_INIT lines of init_engines2 in src/main.cxx (generated, see Makefile)
+#include "engines.inc"
+}
+
+namespace host
+{
+    void init_engines()
+    {
+        if (_engines.empty())
+            init_engines2();
+    }
+} // namespace host
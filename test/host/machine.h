@@ -0,0 +1,458 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+////////////////////////////////////////////////////////////////////////////////
+// Host (Linux) stand-in for the machine API of libsquares-and-circles-machine.
+// Only what the engines in src/*.cxx need - no UI, no hardware I/O.
+////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <new>
+#include <algorithm>
+#include <functional>
+#include "stmlib/dsp/dsp.h" // ONE_POLE
+
+#ifndef FLASHMEM
+#define FLASHMEM
+#endif
+
+#define LEN_OF(x) (sizeof(x) / sizeof(x[0]))
+#define MACHINE_INIT(init_fun) void init_fun();
+
+// Block size of the host build (make BLOCK_SIZE=8/24/48/96)
+#ifndef MACHINE_FRAME_BUFFER_SIZE
+#define MACHINE_FRAME_BUFFER_SIZE 24
+#endif
+
+namespace machine
+{
+    constexpr int FRAME_BUFFER_SIZE = MACHINE_FRAME_BUFFER_SIZE;
+    constexpr int SAMPLE_RATE = 48000;
+    constexpr int DEFAULT_NOTE = 60;
+    constexpr int PITCH_PER_OCTAVE = 12 * 128;
+
+    constexpr const char *M_OSC = "M-OSC";
+    constexpr const char *DRUM = "DRUM";
+    constexpr const char *SYNTH = "SYNTH";
+    constexpr const char *FX = "FX";
+    constexpr const char *CV = "CV";
+
+    constexpr const char *OUT_OF_MEMORY = "OUT OF MEMORY!";
+
+    enum
+    {
+        AUX_L = 0,
+        AUX_R = 1,
+    };
+
+    enum EngineProps : uint32_t
+    {
+        TRIGGER_INPUT = 1 << 0,
+        VOCT_INPUT = 1 << 1,
+        ACCENT_INPUT = 1 << 2,
+        STEREOLIZED = 1 << 3,
+        AUDIO_PROCESSOR = 1 << 4,
+        AUDIO_PROCESSOR_MONO = 1 << 5,
+        OUT_EQ_VOLT = 1 << 8,
+        OUT_EQ_VOLT_INT16 = 1 << 9,
+        MIDI_ENGINE = 1 << 10,
+        SEQUENCER_ENGINE = 1 << 11,
+    };
+
+    struct IO
+    {
+        uint8_t tr = 1;     // trigger input (0 = not patched)
+        uint8_t aux = 0;    // aux input (0 = not patched)
+        uint8_t stereo = 0; // stereo spread 0..255
+        bool is_stereo() const { return stereo > 0; }
+    };
+
+    struct ControlFrame
+    {
+        uint32_t t = 0;
+        bool trigger = false;
+        bool gate = false;
+        bool accent = false;
+        uint32_t clock = 0;
+        float cv_voltage = 0;
+        struct
+        {
+            uint8_t key;
+            uint8_t velocity;
+            int16_t pitch;
+        } midi = {};
+
+        float qz_voltage(const IO *io, float f) const
+        {
+            return f + cv_voltage;
+        }
+
+        int32_t qz_voltage(const IO *io, int32_t i) const
+        {
+            return i + (int32_t)(cv_voltage * PITCH_PER_OCTAVE);
+        }
+    };
+
+    struct OutputFrame
+    {
+        const float *out = nullptr;
+        const float *aux = nullptr;
+
+        template <typename T>
+        void push(const T *buf, size_t len);
+
+        void push_voltage(const int32_t *v, size_t len)
+        {
+            float *dst = out == nullptr ? _out : _aux;
+            for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+                dst[i] = (float)v[len < (size_t)FRAME_BUFFER_SIZE ? std::min((size_t)i, len - 1) : i] / PITCH_PER_OCTAVE / 10.f;
+
+            if (out == nullptr)
+                out = dst;
+            else
+                aux = dst;
+        }
+
+    private:
+        float _out[FRAME_BUFFER_SIZE];
+        float _aux[FRAME_BUFFER_SIZE];
+    };
+
+    template <>
+    inline void OutputFrame::push<float>(const float *buf, size_t len)
+    {
+        if (out == nullptr)
+            out = buf;
+        else
+            aux = buf;
+    }
+
+    template <>
+    inline void OutputFrame::push<int16_t>(const int16_t *buf, size_t len)
+    {
+        float *dst = out == nullptr ? _out : _aux;
+        for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+            dst[i] = (float)buf[len < (size_t)FRAME_BUFFER_SIZE ? std::min((size_t)i, len - 1) : i] / INT16_MAX;
+
+        if (out == nullptr)
+            out = dst;
+        else
+            aux = dst;
+    }
+
+    struct Parameter
+    {
+        enum Flags : uint8_t
+        {
+            IS_SELECTED = 1 << 0,
+            IS_V_OCT = 1 << 1,
+            IS_PRESET = 1 << 2,
+        };
+
+        enum Type : uint8_t
+        {
+            NONE,
+            FLOAT,
+            UINT8,
+            UINT16,
+        };
+
+        const char *name = nullptr;
+        uint8_t type = NONE;
+        uint8_t flags = 0;
+
+        union
+        {
+            float *fp;
+            uint8_t *u8p;
+            uint16_t *u16p;
+        } value = {};
+
+        union
+        {
+            float f;
+            int32_t i;
+        } step = {}, step2 = {};
+
+        float min = 0;
+        float max = 1;
+
+        std::function<void(char *)> print_value = nullptr;
+        std::function<void()> value_changed = nullptr;
+
+        void init(const char *name, float *v, float def = 0.5f, float min = 0, float max = 1)
+        {
+            init_type(name, FLOAT, min, max);
+            value.fp = v;
+            step.f = step2.f = (max - min) / 128;
+            *v = def;
+        }
+
+        void init(const char *name, uint8_t *v, int def = 128, int min = 0, int max = UINT8_MAX)
+        {
+            init_type(name, UINT8, min, max);
+            value.u8p = v;
+            step.i = step2.i = 1;
+            *v = def;
+        }
+
+        void init(const char *name, uint16_t *v, int def = INT16_MAX, int min = 0, int max = UINT16_MAX)
+        {
+            init_type(name, UINT16, min, max);
+            value.u16p = v;
+            step.i = step2.i = 512;
+            *v = def;
+        }
+
+        void init_presets(const char *name, uint8_t *v, int def, int min, int max)
+        {
+            init(name, v, def, min, max);
+            flags |= IS_PRESET;
+        }
+
+        void init_v_oct(const char *name, float *v)
+        {
+            init(name, v, 0, -4.f, 4.f);
+            flags |= IS_V_OCT;
+            step.f = 1.f / 12;
+            step2.f = 1.f;
+        }
+
+        void init_v_oct(const char *name, uint16_t *v)
+        {
+            init(name, v, *v, 0, 10 * PITCH_PER_OCTAVE);
+            flags |= IS_V_OCT;
+            step.i = PITCH_PER_OCTAVE / 12;
+            step2.i = PITCH_PER_OCTAVE;
+        }
+
+        float to_float() const
+        {
+            float v = 0;
+            switch (type)
+            {
+            case FLOAT:
+                v = *value.fp;
+                break;
+            case UINT8:
+                v = *value.u8p;
+                break;
+            case UINT16:
+                v = *value.u16p;
+                break;
+            default:
+                return 0;
+            }
+            return max > min ? std::clamp((v - min) / (max - min), 0.f, 1.f) : 0;
+        }
+
+        uint16_t to_uint16() const
+        {
+            return to_float() * UINT16_MAX;
+        }
+
+        // Sets the normalized value (0..1) and notifies the engine
+        void from_float(float f)
+        {
+            f = std::clamp(f, 0.f, 1.f);
+            switch (type)
+            {
+            case FLOAT:
+                *value.fp = min + (max - min) * f;
+                break;
+            case UINT8:
+                *value.u8p = lroundf(min + (max - min) * f);
+                break;
+            case UINT16:
+                *value.u16p = lroundf(min + (max - min) * f);
+                break;
+            default:
+                return;
+            }
+
+            if (value_changed)
+                value_changed();
+        }
+
+        // Modulation in Volt (-10...+10) = half the parameter range, V/OCT parameters in octaves
+        void modulate(float v)
+        {
+            if (type == FLOAT && (flags & IS_V_OCT))
+                *value.fp += v;
+            else if (type == FLOAT)
+                *value.fp = std::clamp(*value.fp + v / 20 * (max - min), min, max);
+            else if (type == UINT8)
+                *value.u8p = std::clamp(*value.u8p + v / 20 * (max - min), min, max);
+            else if (type == UINT16)
+                *value.u16p = std::clamp(*value.u16p + v / 20 * (max - min), min, max);
+        }
+
+    private:
+        void init_type(const char *name, Type type, float min, float max)
+        {
+            this->name = name;
+            this->type = type;
+            this->flags = 0;
+            this->min = min;
+            this->max = max;
+        }
+    };
+
+    struct Engine
+    {
+        const uint32_t props;
+        Parameter param[6];
+        IO *io = nullptr;
+
+        Engine(uint32_t props = 0) : props(props) {}
+        virtual ~Engine() {}
+
+        virtual bool init() { return true; }
+        virtual void process(const ControlFrame &frame, OutputFrame &of) = 0;
+        virtual void display() {}
+        virtual void display_screensaver() {}
+    };
+
+    struct MidiEngine : Engine
+    {
+        MidiEngine(uint32_t props = MIDI_ENGINE) : Engine(props) {}
+
+        virtual void onMidiNote(uint8_t key, uint8_t velocity) = 0; // NoteOff: velocity == 0
+        virtual void onMidiPitchbend(int16_t pitch) = 0;
+        virtual void onMidiCC(uint8_t ccc, uint8_t value) = 0;
+    };
+
+    struct ModulationSource
+    {
+        uint8_t src = 1;
+        Parameter param[4];
+
+        virtual ~ModulationSource() {}
+        virtual void process(Parameter &target, ControlFrame &frame) = 0;
+
+        virtual void eeprom(std::function<void(void *, size_t)> read_write) {}
+        virtual void display(int x, int y) {}
+    };
+
+    struct QuantizerScale
+    {
+        int16_t span;
+        size_t num_notes;
+        int16_t notes[16];
+    };
+
+    void *malloc(size_t size);
+    void mfree(void *ptr);
+
+    const uint8_t *flash_read(const char *blob_name);
+    void register_symbol(const char *name, void *ptr);
+    void message(const char *fmt, ...);
+
+    uint32_t get_bpm(); // bpm * 100
+    float *get_aux(int channel);
+    void get_audio(int channel, float *buffer, float gain); // buffer += input * gain
+    float get_cv(int channel);
+    bool get_trigger(int channel);
+    bool get_gate(int channel);
+    int get_io_info(int type, int index = -1, char *name = nullptr);
+
+    void dmod_init_reception(const char *blob_name, size_t size);
+    bool dmod_process(const int16_t *samples, size_t &received);
+
+    void add(const uint8_t *bin, size_t len); // dynamic loaded app (not supported on host)
+    void add_quantizer_scale(const char *name, const QuantizerScale &scale);
+
+    void add_engine(const char *machine, const char *name, std::function<Engine *()> create);
+    void add_modulation_source(const char *name, std::function<ModulationSource *()> create);
+    ModulationSource *create_modulation(const char *name);
+} // namespace machine
+
+// Host only, not part of the firmware API: heap footprints of the registered engines (heap budget, heap_report)
+namespace host
+{
+    // Footprint of the engine / modulation source registered last
+    void declare_engine_footprint(size_t footprint);
+    void declare_modulation_footprint(size_t footprint);
+
+    // Heap needed by an engine (incl. the engine itself): T::memory_footprint(args...) if declared, else sizeof(T)
+    template <class T, typename... Args>
+    auto memory_footprint(int, const Args &...args) -> decltype(T::memory_footprint(args...))
+    {
+        return T::memory_footprint(args...);
+    }
+
+    template <class T, typename... Args>
+    size_t memory_footprint(long, const Args &...)
+    {
+        return sizeof(T);
+    }
+} // namespace host
+
+namespace machine
+{
+    template <class T, typename... Args>
+    void add(const char *machine, const char *name, Args... args)
+    {
+        add_engine(machine, name, [=]() -> Engine *
+                   {
+                       if (void *mem = machine::malloc(sizeof(T)))
+                           return new (mem) T(args...);
+                       return nullptr; });
+        host::declare_engine_footprint(host::memory_footprint<T>(0, args...));
+    }
+
+    template <class T>
+    void add_modulation_source(const char *name)
+    {
+        add_modulation_source(name, []() -> ModulationSource *
+                              {
+                                  if (void *mem = machine::malloc(sizeof(T)))
+                                      return new (mem) T();
+                                  return nullptr; });
+        host::declare_modulation_footprint(sizeof(T));
+    }
+} // namespace machine
+
+namespace gfx
+{
+    extern uint8_t *display_buffer;
+
+    void drawEngine(machine::Engine *engine, const char *msg = nullptr);
+    void drawEngineCompact(machine::Engine *engine);
+    void DrawKnob(int x, int y, const char *name, uint16_t value, bool selected);
+    void drawString(int x, int y, const char *s, int font = 1);
+    void drawLine(int x1, int y1, int x2, int y2);
+    void drawRect(int x, int y, int w, int h);
+    void fillRect(int x, int y, int w, int h);
+    void drawCircle(int x, int y, int r);
+    void drawXbm(int x, int y, int w, int h, const uint8_t *xbm);
+    void setPixel(int x, int y);
+} // namespace gfx
@@ -0,0 +1,140 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// Offline renderer: runs every registered engine for N seconds and writes a WAV file per engine
+//
+//   render [-s seconds] [-o outdir] [-f flashdir] [-l] [engine-filter ...]
+
+#include "host.h"
+#include <chrono>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace machine;
+
+static std::string file_name(const host::EngineEntry &entry)
+{
+    std::string s = std::string(entry.machine) + "_" + entry.name;
+    for (auto &c : s)
+        if (!isalnum(c) && c != '-' && c != '_' && c != '.')
+            c = '_';
+    return s;
+}
+
+int main(int argc, char **argv)
+{
+    float seconds = 2.f;
+    std::string outdir = "render";
+    bool list = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:o:f:l")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            seconds = atof(optarg);
+            break;
+        case 'o':
+            outdir = optarg;
+            break;
+        case 'f':
+            host::flash_dir = optarg;
+            break;
+        case 'l':
+            list = true;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s seconds] [-o outdir] [-f flashdir] [-l] [engine-filter ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    host::init_engines();
+
+    if (!list)
+        mkdir(outdir.c_str(), 0755);
+
+    int failed = 0;
+
+    for (auto &entry : host::engines())
+    {
+        if (!host::matches(entry, argc - optind, &argv[optind]))
+            continue;
+
+        if (list)
+        {
+            printf("%s/%s\n", entry.machine, entry.name);
+            continue;
+        }
+
+        IO io;
+        io.aux = 1; // input 1 for the EnvFollower
+        Engine *engine = host::create_engine(entry, &io);
+        if (engine == nullptr)
+        {
+            printf("%-12s %-16s SKIPPED (init failed - missing flash data?)\n", entry.machine, entry.name);
+            continue;
+        }
+
+        const uint32_t blocks = seconds * host::BLOCKS_PER_SECOND;
+        std::vector<float> left, right;
+        left.reserve(blocks * FRAME_BUFFER_SIZE);
+        right.reserve(blocks * FRAME_BUFFER_SIZE);
+
+        host::Stimulus stimulus;
+        ControlFrame frame;
+        std::chrono::nanoseconds elapsed(0);
+
+        for (uint32_t t = 0; t < blocks; t++)
+        {
+            stimulus.next(t, frame, engine);
+
+            OutputFrame of;
+            auto t0 = std::chrono::steady_clock::now();
+            engine->process(frame, of);
+            elapsed += std::chrono::steady_clock::now() - t0;
+
+            const float *l = of.out;
+            const float *r = of.aux ? of.aux : of.out;
+            for (int i = 0; i < FRAME_BUFFER_SIZE; i++)
+            {
+                left.push_back(l ? l[i] : 0);
+                right.push_back(r ? r[i] : 0);
+            }
+        }
+
+        std::string path = outdir + "/" + file_name(entry) + ".wav";
+        if (!host::write_wav(path.c_str(), left, right))
+            failed++;
+
+        printf("%-12s %-16s %8.0f ns/block  %s\n", entry.machine, entry.name,
+               blocks ? (double)elapsed.count() / blocks : 0.0, path.c_str());
+
+        host::destroy_engine(engine);
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,214 @@
+// Copyright (C)2024 - Eduard Heidt
+//
+// Author: Eduard Heidt (eh2k@gmx.de)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+//
+// See http://creativecommons.org/licenses/MIT/ for more information.
+//
+
+// Engine swap stress test: replays random program changes on the 4 slots (like test/test_midi.sh)
+// against the T4 heap model, once with plain machine::malloc and once with per-slot arenas.
+// Reports loads that failed although the declared footprints fit (fragmentation), the slot
+// compactions (Slot::compact) needed to avoid that, and the peak fragmentation of the heap.
+//
+//   stress_slots [-n changes] [-b budget_kb] [-r seed] [-f flashdir] [engine-filter ...]
+
+#include "host.h"
+#include <unistd.h>
+
+using namespace machine;
+
+constexpr int SLOTS = 4;
+constexpr uint32_t BLOCKS_PER_CHANGE = 8;
+
+struct Result
+{
+    int loaded = 0;
+    int refused = 0; // declared footprints do not fit into the budget
+    int failed = 0;  // allocation failed although the footprints fit
+    int compacted = 0;
+    float peak_fragmentation = 0;
+    size_t min_largest_free = SIZE_MAX;
+};
+
+static uint32_t next(uint32_t &seed)
+{
+    seed = seed * 1664525L + 1013904223L;
+    return seed >> 8;
+}
+
+static Result run(bool arenas, const std::vector<const host::EngineEntry *> &engines, int changes, size_t budget, uint32_t seed)
+{
+    Result result;
+    host::set_heap_budget(budget);
+
+    IO io[SLOTS];
+    host::Slot slot[SLOTS];
+    Engine *engine[SLOTS] = {};
+    size_t declared[SLOTS] = {};
+    host::Stimulus stimulus[SLOTS];
+    uint32_t t[SLOTS] = {};
+
+    const size_t reserve = arenas ? host::Slot::ARENA_RESERVE : 0;
+
+    for (int i = 0; i < changes; i++)
+    {
+        const int s = next(seed) % SLOTS;
+        const host::EngineEntry &entry = *engines[next(seed) % engines.size()];
+
+        if (arenas)
+            slot[s].unload();
+        else
+            host::destroy_engine(engine[s]);
+
+        engine[s] = nullptr;
+        declared[s] = 0;
+
+        size_t total = entry.footprint + reserve;
+        for (int k = 0; k < SLOTS; k++)
+            total += declared[k] ? declared[k] + reserve : 0;
+
+        if (total > budget)
+        {
+            result.refused++;
+            continue;
+        }
+
+        size_t failures = host::heap_failures();
+        if (arenas)
+        {
+            engine[s] = slot[s].load(entry, &io[s]);
+            if (engine[s] == nullptr)
+            {
+                host::Slot::compact(slot, SLOTS);
+                result.compacted++;
+                for (int k = 0; k < SLOTS; k++)
+                    engine[k] = slot[k].engine();
+
+                failures = host::heap_failures();
+                engine[s] = slot[s].load(entry, &io[s]);
+            }
+        }
+        else
+            engine[s] = host::create_engine(entry, &io[s]);
+
+        declared[s] = engine[s] ? entry.footprint : 0;
+        t[s] = 0;
+
+        // The engines allocate at runtime, too (preset changes, program loading in display)
+        for (int k = 0; k < SLOTS; k++)
+        {
+            if (engine[k] == nullptr)
+                continue;
+
+            host::Slot::Scope *scope = arenas ? new host::Slot::Scope(slot[k]) : nullptr;
+            for (uint32_t b = 0; b < BLOCKS_PER_CHANGE; b++, t[k]++)
+            {
+                ControlFrame frame;
+                OutputFrame of;
+                stimulus[k].next(t[k], frame, engine[k]);
+                engine[k]->process(frame, of);
+            }
+            engine[k]->display();
+            delete scope;
+        }
+
+        if (engine[s] == nullptr || host::heap_failures() != failures)
+            result.failed++;
+        else
+            result.loaded++;
+
+        const host::Arena *heap = host::heap();
+        result.peak_fragmentation = std::max(result.peak_fragmentation, heap->fragmentation());
+        result.min_largest_free = std::min(result.min_largest_free, heap->largest_free());
+    }
+
+    for (int k = 0; k < SLOTS; k++)
+    {
+        if (arenas)
+            slot[k].unload();
+        else
+            host::destroy_engine(engine[k]);
+    }
+
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int changes = 2000;
+    size_t budget = 512 * 1024;
+    uint32_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:b:r:f:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            changes = atoi(optarg);
+            break;
+        case 'b':
+            budget = atoi(optarg) * 1024;
+            break;
+        case 'r':
+            seed = atoi(optarg);
+            break;
+        case 'f':
+            host::flash_dir = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n changes] [-b budget_kb] [-r seed] [-f flashdir] [engine-filter ...]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    host::init_engines();
+
+    // Engines that can not be created on the host at all (missing flash blobs) are left out
+    std::vector<const host::EngineEntry *> engines;
+    for (auto &entry : host::engines())
+    {
+        if (!host::matches(entry, argc - optind, &argv[optind]))
+            continue;
+
+        IO io;
+        if (Engine *engine = host::create_engine(entry, &io))
+        {
+            host::destroy_engine(engine);
+            engines.push_back(&entry);
+        }
+    }
+
+    if (engines.empty())
+        return 1;
+
+    printf("%d program changes, %zu engines, %zuK heap\n", changes, engines.size(), budget / 1024);
+    printf("%-8s %8s %8s %8s %10s %10s %14s\n", "mode", "loaded", "refused", "failed", "compacted", "peak frag", "min largest");
+
+    Result plain = run(false, engines, changes, budget, seed);
+    Result slots = run(true, engines, changes, budget, seed);
+
+    for (auto &it : {std::make_pair("malloc", plain), std::make_pair("arenas", slots)})
+        printf("%-8s %8d %8d %8d %10d %9.1f%% %14zu\n", it.first, it.second.loaded, it.second.refused, it.second.failed,
+               it.second.compacted, it.second.peak_fragmentation * 100.f, it.second.min_largest_free);
+
+    return slots.failed ? 1 : 0;
+}